@@ -0,0 +1,87 @@
+//============================================================================
+// Name        : BlockedBloomFilter.h
+// Author      : Sonny Coutu
+// Description : Split-block Bloom filter for rejecting course IDs that are not
+//               in the catalog. Each key maps to one 64-byte block and sets one
+//               bit in each of its eight words, so a lookup touches a single
+//               cache line. No false negatives; about 1% false positives at
+//               the default 10 bits per key.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class BlockedBloomFilter {
+private:
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
+
+    std::vector<Block> blocks;
+    size_t bitsPerKey = 10;
+
+    // FNV-1a followed by a MurmurHash3 finalizer so every output bit is mixed
+    static uint64_t hashKey(std::string_view key) {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Bit to set in each word of the block, derived from the low hash half
+    static void bitMasks(uint64_t h, uint64_t masks[8]) {
+        static const uint32_t SALT[8] = { 0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                                          0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+        uint32_t low = static_cast<uint32_t>(h);
+        for (int i = 0; i < 8; ++i) masks[i] = uint64_t(1) << ((low * SALT[i]) >> 26);
+    }
+
+    // Block chosen by the high hash half (multiply-shift instead of modulo)
+    size_t blockIndex(uint64_t h) const {
+        return static_cast<size_t>(((h >> 32) * blocks.size()) >> 32);
+    }
+
+public:
+    // Empties the filter and sizes it for expectedKeys
+    void Reset(size_t expectedKeys, size_t keyBits = 10) {
+        bitsPerKey = keyBits;
+        size_t count = (expectedKeys * bitsPerKey + 511) / 512;
+        blocks.assign(count > 0 ? count : 1, Block{});
+    }
+
+    void Add(std::string_view key) {
+        if (blocks.empty()) Reset(1);
+        uint64_t h = hashKey(key);
+        uint64_t masks[8];
+        bitMasks(h, masks);
+        Block& block = blocks[blockIndex(h)];
+        for (int i = 0; i < 8; ++i) block.words[i] |= masks[i];
+    }
+
+    // False means the key was never added; true means it probably was
+    bool MayContain(std::string_view key) const {
+        if (blocks.empty()) return false;
+        uint64_t h = hashKey(key);
+        uint64_t masks[8];
+        bitMasks(h, masks);
+        const Block& block = blocks[blockIndex(h)];
+        uint64_t missing = 0;
+        for (int i = 0; i < 8; ++i) missing |= masks[i] & ~block.words[i];
+        return missing == 0;
+    }
+
+    // Keys the filter was sized for
+    size_t Capacity() const { return blocks.size() * 512 / bitsPerKey; }
+
+    size_t Bytes() const { return blocks.capacity() * sizeof(Block); }
+};
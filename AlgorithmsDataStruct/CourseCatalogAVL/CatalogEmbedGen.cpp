@@ -0,0 +1,219 @@
+//============================================================================
+// Name        : CatalogEmbedGen.cpp
+// Author      : Sonny Coutu
+// Description : Build step for kiosk builds. Compiles a catalog CSV into a
+//               header of constexpr tables for EmbeddedCatalog.h: the courses
+//               sorted by ID, their prerequisites, and a minimal perfect hash
+//               over the IDs. The CSV is read with the normal loader, so
+//               duplicates and blank fields are handled as at runtime. The
+//               header is only rewritten when its contents change, so an
+//               unchanged CSV does not trigger a recompile.
+//               Usage: CatalogEmbedGen courses.csv EmbeddedCourses.h
+//============================================================================
+
+#include "CourseCatalog.h"
+#include "EmbeddedCatalog.h"
+
+#include <filesystem>
+#include <numeric>
+
+// Perfect-hash tables in the layout EmbeddedCatalog reads
+struct PerfectHash {
+    vector<uint32_t> seeds; // Per bucket
+    vector<uint32_t> slots; // Slot -> course index
+};
+
+// Hash and displace: buckets are placed largest first, each with the first
+// seed that sends every key in it to a distinct free slot. About four keys per
+// bucket keeps the seed table small and the search short.
+bool buildPerfectHash(const vector<Course>& courses, PerfectHash& mph) {
+    uint32_t n = static_cast<uint32_t>(courses.size());
+    uint32_t bucketCount = max<uint32_t>(1, (n + 3) / 4);
+    vector<uint64_t> hashes(n);
+    for (uint32_t i = 0; i < n; ++i) hashes[i] = embeddedKeyHash(courses[i].courseNumber);
+
+    // Two IDs with the same 64-bit hash can never be separated by a seed
+    vector<uint32_t> byHash(n);
+    iota(byHash.begin(), byHash.end(), 0);
+    sort(byHash.begin(), byHash.end(), [&hashes](uint32_t a, uint32_t b) { return hashes[a] < hashes[b]; });
+    for (uint32_t i = 1; i < n; ++i) {
+        if (hashes[byHash[i]] == hashes[byHash[i - 1]]) {
+            cout << "Course IDs " << courses[byHash[i - 1]].courseNumber << " and " << courses[byHash[i]].courseNumber
+                 << " have the same hash; cannot build the perfect hash." << endl;
+            return false;
+        }
+    }
+
+    vector<vector<uint32_t>> buckets(bucketCount);
+    for (uint32_t i = 0; i < n; ++i) buckets[embeddedBucket(hashes[i], bucketCount)].push_back(i);
+    vector<uint32_t> order(bucketCount);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    mph.seeds.assign(bucketCount, 0);
+    mph.slots.assign(n, 0);
+    vector<bool> taken(n, false);
+    vector<uint32_t> trial;
+    for (uint32_t b : order) {
+        const vector<uint32_t>& bucket = buckets[b];
+        if (bucket.empty()) break; // sorted by size, so the rest are empty too
+        for (uint64_t seed = 0;; ++seed) {
+            if (seed > UINT32_MAX) {
+                cout << "No perfect-hash seed found for a bucket of " << bucket.size() << " courses." << endl;
+                return false;
+            }
+            trial.clear();
+            for (uint32_t key : bucket) {
+                uint32_t slot = embeddedSlot(hashes[key], static_cast<uint32_t>(seed), n);
+                if (taken[slot] || find(trial.begin(), trial.end(), slot) != trial.end()) break;
+                trial.push_back(slot);
+            }
+            if (trial.size() < bucket.size()) continue;
+            for (size_t k = 0; k < bucket.size(); ++k) {
+                taken[trial[k]] = true;
+                mph.slots[trial[k]] = bucket[k];
+            }
+            mph.seeds[b] = static_cast<uint32_t>(seed);
+            break;
+        }
+    }
+    return true;
+}
+
+// A C++ string_view literal holding exactly these bytes; anything outside
+// printable ASCII is written as a three-digit octal escape
+void appendLiteral(string& out, string_view text) {
+    out += '"';
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (c == '"' || c == '\\' || c == '?') { // '?' so "??x" is never read as a trigraph
+            out += '\\';
+            out += ch;
+        }
+        else if (c >= 0x20 && c < 0x7F) out += ch;
+        else {
+            char escape[5] = { '\\', static_cast<char>('0' + (c >> 6)), static_cast<char>('0' + ((c >> 3) & 7)),
+                               static_cast<char>('0' + (c & 7)), '\0' };
+            out += escape;
+        }
+    }
+    out += "\"sv";
+}
+
+// Comma-separated numbers, sixteen to a line
+void appendNumbers(string& out, const vector<uint32_t>& numbers) {
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        out += i % 16 == 0 ? "\n    " : " ";
+        out += to_string(numbers[i]);
+        out += ',';
+    }
+    out += '\n';
+}
+
+string generateHeader(const string& sourceName, const string& headerName, const vector<Course>& courses, const PerfectHash& mph) {
+    size_t prereqTotal = 0;
+    for (const Course& c : courses) prereqTotal += c.preReqs.size();
+
+    string out;
+    out += "//============================================================================\n";
+    out += "// Name        : " + headerName + "\n";
+    out += "// Description : Generated by CatalogEmbedGen from " + sourceName + "; do not edit.\n";
+    out += "//               " + to_string(courses.size()) + " courses, " + to_string(mph.seeds.size()) + " perfect-hash buckets.\n";
+    out += "//============================================================================\n\n";
+    out += "#pragma once\n\n#include \"EmbeddedCatalog.h\"\n\n";
+    out += "using namespace std::string_view_literals;\n\n";
+    out += "inline constexpr std::string_view EMBEDDED_SOURCE = ";
+    appendLiteral(out, sourceName);
+    out += ";\n\n";
+
+    if (courses.empty()) {
+        out += "inline constexpr EmbeddedCatalog EMBEDDED_CATALOG{};\n";
+        return out;
+    }
+
+    out += "inline constexpr EmbeddedCourse EMBEDDED_COURSES[] = {\n";
+    uint32_t firstPrereq = 0;
+    for (const Course& c : courses) {
+        out += "    { ";
+        appendLiteral(out, c.courseNumber);
+        out += ", ";
+        appendLiteral(out, c.courseName);
+        out += ", " + to_string(firstPrereq) + ", " + to_string(c.preReqs.size()) + " },\n";
+        firstPrereq += static_cast<uint32_t>(c.preReqs.size());
+    }
+    out += "};\n\n";
+
+    if (prereqTotal) {
+        out += "inline constexpr std::string_view EMBEDDED_PREREQS[] = {\n";
+        for (const Course& c : courses) {
+            for (const string& pre : c.preReqs) {
+                out += "    ";
+                appendLiteral(out, pre);
+                out += ",\n";
+            }
+        }
+        out += "};\n\n";
+    }
+
+    out += "inline constexpr uint32_t EMBEDDED_SEEDS[] = {";
+    appendNumbers(out, mph.seeds);
+    out += "};\n\ninline constexpr uint32_t EMBEDDED_SLOTS[] = {";
+    appendNumbers(out, mph.slots);
+    out += "};\n\n";
+
+    out += "inline constexpr EmbeddedCatalog EMBEDDED_CATALOG(EMBEDDED_COURSES, ";
+    out += prereqTotal ? "EMBEDDED_PREREQS" : "std::span<const std::string_view>()";
+    out += ", EMBEDDED_SEEDS, EMBEDDED_SLOTS);\n\n";
+
+    // Checked by the compiler: the tables answer lookups for the first and last course
+    for (size_t i : { size_t(0), courses.size() - 1 }) {
+        out += "static_assert(EMBEDDED_CATALOG.Find(";
+        appendLiteral(out, courses[i].courseNumber);
+        out += ") == &EMBEDDED_COURSES[" + to_string(i) + "]);\n";
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cout << "Usage: CatalogEmbedGen courses.csv EmbeddedCourses.h" << endl;
+        return 1;
+    }
+    string csvPath = argv[1], headerPath = argv[2];
+    if (!filesystem::exists(csvPath)) {
+        cout << "Could not open file (" << csvPath << ")." << endl;
+        return 1;
+    }
+
+    BinarySearchTree catalog;
+    loadCourses(csvPath, &catalog);
+    vector<Course> courses;
+    courses.reserve(static_cast<size_t>(catalog.Size()));
+    catalog.ForEach([&courses](const Course& c) { courses.push_back(c); });
+    if (courses.size() >= UINT32_MAX) {
+        cout << "Too many courses to embed (" << courses.size() << ")." << endl;
+        return 1;
+    }
+
+    PerfectHash mph;
+    if (!buildPerfectHash(courses, mph)) return 1;
+    string header = generateHeader(filesystem::path(csvPath).filename().string(),
+                                   filesystem::path(headerPath).filename().string(), courses, mph);
+
+    ifstream existing(headerPath, ios::binary);
+    if (existing.is_open()) {
+        string current((istreambuf_iterator<char>(existing)), istreambuf_iterator<char>());
+        if (current == header) {
+            cout << headerPath << " is up to date (" << courses.size() << " courses)." << endl;
+            return 0;
+        }
+        existing.close();
+    }
+    ofstream out(headerPath, ios::binary | ios::trunc);
+    if (!out.is_open() || !(out << header) || !(out.flush())) {
+        cout << "Could not write file (" << headerPath << ")." << endl;
+        return 1;
+    }
+    cout << "Wrote " << courses.size() << " courses to " << headerPath << "." << endl;
+    return 0;
+}
@@ -0,0 +1,226 @@
+//============================================================================
+// Name        : CatalogExport.h
+// Author      : Sonny Coutu
+// Description : Streams a catalog to a file in key order: as CSV in the
+//               exact format loadCourses reads, as JSON Lines, or as one JSON
+//               array. Records are formatted straight into one large output
+//               buffer (no per-record strings or iostreams) that is handed to
+//               the OS in multi-megabyte writes, so big exports run at disk
+//               speed.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+enum class ExportFormat { CSV, JSON_LINES, JSON_ARRAY };
+
+// .jsonl and .ndjson files get JSON Lines (one object per line), .json files
+// get a single array that any JSON parser reads; anything else gets CSV
+inline ExportFormat exportFormatFor(const string& path) {
+    string extension = filesystem::path(path).extension().string();
+    convertCase(extension);
+    if (extension == ".JSONL" || extension == ".NDJSON") return ExportFormat::JSON_LINES;
+    if (extension == ".JSON") return ExportFormat::JSON_ARRAY;
+    return ExportFormat::CSV;
+}
+
+struct ExportResult {
+    bool ok = false;
+    size_t courses = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+};
+
+// Write-only file with one large buffer in front of it. stdio's own buffer is
+// turned off, so every byte is copied once: from the course into the buffer.
+class ExportSink {
+private:
+    FILE* file = nullptr;
+    vector<char> buffer;
+    size_t used = 0;
+    uint64_t written = 0;
+    bool failed = false;
+
+    void writeOut(const char* data, size_t length) {
+        if (failed || length == 0) return;
+        if (fwrite(data, 1, length, file) != length) failed = true;
+        written += length;
+    }
+
+    void drain() {
+        writeOut(buffer.data(), used);
+        used = 0;
+    }
+
+public:
+    static const size_t BUFFER_BYTES = 4 << 20;
+
+    ~ExportSink() {
+        if (file) fclose(file);
+    }
+
+    bool Open(const string& path) {
+#ifdef _WIN32
+        if (fopen_s(&file, path.c_str(), "wb") != 0) file = nullptr;
+#else
+        file = fopen(path.c_str(), "wb");
+#endif
+        if (!file) return false;
+        setvbuf(file, nullptr, _IONBF, 0);
+        buffer.resize(BUFFER_BYTES);
+        return true;
+    }
+
+    void Append(const char* data, size_t length) {
+        if (length > buffer.size() - used) {
+            drain();
+            if (length > buffer.size()) { // larger than the whole buffer: skip the copy
+                writeOut(data, length);
+                return;
+            }
+        }
+        memcpy(buffer.data() + used, data, length);
+        used += length;
+    }
+
+    void Append(string_view text) { Append(text.data(), text.size()); }
+
+    void Append(char c) {
+        if (used == buffer.size()) drain();
+        buffer[used++] = c;
+    }
+
+    // Flushes the buffer and closes the file; false if any write failed
+    bool Close() {
+        drain();
+        bool ok = !failed && fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+    uint64_t BytesWritten() const { return written + used; }
+};
+
+// Why loadCourses would not read a field back unchanged, or nullptr if it would.
+// The loader splits on ',' and line breaks, trims spaces and tabs, and drops
+// empty prerequisites; it has no quoting, so such fields cannot be escaped.
+inline const char* csvFieldProblem(string_view field, bool allowEmpty) {
+    if (field.empty()) return allowEmpty ? nullptr : "is empty";
+    if (field.find_first_of(",\r\n") != string_view::npos) return "contains a comma or line break";
+    if (field.front() == ' ' || field.front() == '\t' || field.back() == ' ' || field.back() == '\t') {
+        return "starts or ends with a space or tab";
+    }
+    return nullptr;
+}
+
+// One course as a loader row; false (with a message) if it cannot round-trip
+inline bool writeCsvCourse(ExportSink& sink, const Course& c) {
+    const char* problem = csvFieldProblem(c.courseNumber, false);
+    const char* field = "ID";
+    if (!problem && (problem = csvFieldProblem(c.courseName, true))) field = "name";
+    for (size_t i = 0; !problem && i < c.preReqs.size(); ++i) {
+        if ((problem = csvFieldProblem(c.preReqs[i], false))) field = "prerequisite";
+    }
+    if (problem) {
+        cout << "Course " << c.courseNumber << " cannot be written as CSV: its " << field << " " << problem << "." << endl;
+        return false;
+    }
+    sink.Append(c.courseNumber);
+    sink.Append(',');
+    sink.Append(c.courseName);
+    for (const string& pre : c.preReqs) {
+        sink.Append(',');
+        sink.Append(pre);
+    }
+    sink.Append('\n');
+    return true;
+}
+
+// A JSON string literal. Runs of plain bytes are copied in one piece; quotes,
+// backslashes and control characters are escaped. Other bytes (UTF-8) pass through.
+inline void writeJsonString(ExportSink& sink, string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    sink.Append('"');
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        sink.Append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+        case '"': sink.Append("\\\""); break;
+        case '\\': sink.Append("\\\\"); break;
+        case '\n': sink.Append("\\n"); break;
+        case '\r': sink.Append("\\r"); break;
+        case '\t': sink.Append("\\t"); break;
+        default: {
+            char escape[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF] };
+            sink.Append(escape, sizeof(escape));
+        }
+        }
+    }
+    sink.Append(text.data() + runStart, text.size() - runStart);
+    sink.Append('"');
+}
+
+// {"id":"CSCI200","name":"Data Structures","prerequisites":["CSCI101"]}
+inline void writeJsonCourse(ExportSink& sink, const Course& c) {
+    sink.Append("{\"id\":");
+    writeJsonString(sink, c.courseNumber);
+    sink.Append(",\"name\":");
+    writeJsonString(sink, c.courseName);
+    sink.Append(",\"prerequisites\":[");
+    for (size_t i = 0; i < c.preReqs.size(); ++i) {
+        if (i) sink.Append(',');
+        writeJsonString(sink, c.preReqs[i]);
+    }
+    sink.Append("]}");
+}
+
+// Writes every course of any ordered index (see OrderedIndex.h) to path in key
+// order. The file is written beside path and renamed over it when complete, so
+// a failed export leaves any earlier file at path untouched.
+template <typename Index>
+ExportResult exportCatalog(const Index& index, const string& path, ExportFormat format) {
+    TRACE_SCOPE(span, "exportCatalog", "export");
+    ExportResult result;
+    auto start = chrono::steady_clock::now();
+    string tmpPath = path + ".tmp";
+    ExportSink sink;
+    if (!sink.Open(tmpPath)) {
+        cout << "Could not open file (" << tmpPath << ")." << endl;
+        return result;
+    }
+    bool representable = true;
+    if (format == ExportFormat::JSON_ARRAY) sink.Append('[');
+    index.ForEach([&](const Course& c) {
+        if (!representable) return;
+        if (format == ExportFormat::CSV) representable = writeCsvCourse(sink, c);
+        else {
+            if (format == ExportFormat::JSON_ARRAY) sink.Append(result.courses ? ",\n" : "\n");
+            writeJsonCourse(sink, c);
+            if (format == ExportFormat::JSON_LINES) sink.Append('\n');
+        }
+        result.courses += representable;
+    });
+    if (format == ExportFormat::JSON_ARRAY) sink.Append(result.courses ? "\n]\n" : "]\n");
+    result.bytes = sink.BytesWritten();
+    bool ok = sink.Close() && representable;
+    error_code ec;
+    if (ok) filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec) {
+        if (representable) cout << "Could not write file (" << path << ")." << endl;
+        filesystem::remove(tmpPath, ec);
+        return result;
+    }
+    TRACE_ARG(span, "courses", result.courses);
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.ok = true;
+    return result;
+}
@@ -0,0 +1,358 @@
+//============================================================================
+// Name        : CatalogJournal.h
+// Author      : Sonny Coutu
+// Description : Write-ahead log for catalog edits. Insert and Delete are
+//               appended as checksummed records and made durable by a
+//               background flusher that fsyncs whole batches (group commit).
+//               Recovery replays the log over the base CSV, and compaction
+//               folds the log into a new base file.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ---------------- Log format ----------------
+// The file starts with an 8-byte magic, then one record per operation:
+//   u32 payload length, u32 CRC-32 of (op + payload), 1 op byte, payload
+// Integers are little-endian. An insert's payload is the course as a CSV row;
+// a delete's payload is the course ID. A torn or corrupt record ends the log.
+enum JournalOp : char {
+    JOURNAL_INSERT = 'I',
+    JOURNAL_DELETE = 'D'
+};
+
+class CatalogJournal {
+private:
+    static constexpr char FILE_MAGIC[8] = { 'C', 'A', 'T', 'W', 'A', 'L', '0', '1' };
+    static const size_t RECORD_HEADER = 9;
+    static const uint64_t COMPACT_BYTES = 1 << 20; // Fold into the base once the log passes this
+
+    string logPath;
+    FILE* file = nullptr;
+    uint64_t fileBytes = 0;     // Bytes written to the log so far
+    string pending;             // Records appended but not yet written
+    uint64_t nextLsn = 1;       // Sequence number of the next record
+    uint64_t bufferedLsn = 0;   // Last record appended
+    uint64_t durableLsn = 0;    // Last record known to be on disk
+    bool writeFailed = false;
+    bool stopping = false;
+    mutex lock;
+    condition_variable wakeFlusher;
+    condition_variable durable;
+    thread flusher;
+
+    static uint32_t crc32Update(uint32_t crc, const char* data, size_t length) {
+        static const vector<uint32_t> table = [] {
+            vector<uint32_t> t(256);
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i) crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static void appendU32(string& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    static uint32_t readU32(const char* p) {
+        const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+        return uint32_t(u[0]) | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+    }
+
+    static FILE* openFile(const string& path, const char* mode) {
+#ifdef _WIN32
+        FILE* f = nullptr;
+        return fopen_s(&f, path.c_str(), mode) == 0 ? f : nullptr;
+#else
+        return fopen(path.c_str(), mode);
+#endif
+    }
+
+    // Pushes buffered writes to the OS and waits for the device
+    static bool syncFile(FILE* f) {
+        if (fflush(f) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(f)) == 0;
+#else
+        return fsync(fileno(f)) == 0;
+#endif
+    }
+
+    // Makes a rename in the file's directory durable (POSIX only; NTFS journals it)
+    static void syncDirectory(const string& path) {
+#ifndef _WIN32
+        string dir = filesystem::path(path).parent_path().string();
+        int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    // Starts a log holding only the magic
+    bool createEmptyLog() {
+        file = openFile(logPath, "wb");
+        if (!file) return false;
+        fileBytes = sizeof(FILE_MAGIC);
+        return fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), file) == sizeof(FILE_MAGIC) && syncFile(file);
+    }
+
+    uint64_t append(JournalOp op, const string& payload) {
+        uint32_t crc = crc32Update(crc32Update(0, reinterpret_cast<const char*>(&op), 1), payload.data(), payload.size());
+        lock_guard<mutex> guard(lock);
+        if (!file) return 0;
+        appendU32(pending, static_cast<uint32_t>(payload.size()));
+        appendU32(pending, crc);
+        pending.push_back(op);
+        pending += payload;
+        bufferedLsn = nextLsn++;
+        wakeFlusher.notify_one();
+        return bufferedLsn;
+    }
+
+    // Writes and fsyncs everything appended so far. Records appended while a
+    // batch is on its way to disk wait and go out together in the next one.
+    void flushLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wakeFlusher.wait(guard, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) return; // stopping with nothing left
+            string batch;
+            batch.swap(pending);
+            uint64_t batchLsn = bufferedLsn;
+            guard.unlock();
+            bool ok = fwrite(batch.data(), 1, batch.size(), file) == batch.size() && syncFile(file);
+            guard.lock();
+            if (!ok) writeFailed = true;
+            fileBytes += batch.size();
+            durableLsn = batchLsn;
+            durable.notify_all();
+        }
+    }
+
+    // Applies the valid prefix of a log image; validBytes ends at the last good record
+    static size_t replayImage(const vector<char>& image, BinarySearchTree& tree, size_t& validBytes) {
+        validBytes = 0;
+        if (image.size() < sizeof(FILE_MAGIC) || memcmp(image.data(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) return 0;
+        size_t pos = sizeof(FILE_MAGIC);
+        size_t records = 0;
+        vector<string_view> fields;
+        while (image.size() - pos >= RECORD_HEADER) {
+            uint32_t length = readU32(&image[pos]);
+            if (length > image.size() - pos - RECORD_HEADER) break; // torn write
+            const char* body = &image[pos + 8];
+            if (crc32Update(0, body, length + 1) != readU32(&image[pos + 4])) break;
+            string_view payload(body + 1, length);
+            if (body[0] == JOURNAL_INSERT) {
+                splitRow(payload, fields);
+                if (fields.size() >= 2) {
+                    Course c{ string(fields[0]), string(fields[1]), {} };
+                    for (size_t i = 2; i < fields.size(); ++i) {
+                        if (!fields[i].empty()) c.preReqs.emplace_back(fields[i]);
+                    }
+                    tree.Insert(c);
+                }
+            }
+            else if (body[0] == JOURNAL_DELETE) tree.Delete(string(payload));
+            else break;
+            pos += RECORD_HEADER + length;
+            ++records;
+        }
+        validBytes = pos;
+        return records;
+    }
+
+    static vector<char> readImage(const string& path) {
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in.is_open()) return {};
+        vector<char> image(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(image.data(), static_cast<streamsize>(image.size()));
+        image.resize(static_cast<size_t>(in.gcount()));
+        return image;
+    }
+
+    // True if Open may start a new log at path: there is none yet, or it holds
+    // only part of the magic (a crash while it was being created). Anything
+    // else without the magic is someone else's file or a damaged log.
+    static bool isUnstartedLog(const string& path, const vector<char>& image) {
+        error_code ec;
+        if (!filesystem::exists(path, ec)) return !ec;
+        if (filesystem::file_size(path, ec) != image.size() || ec) return false; // not fully readable
+        return image.size() < sizeof(FILE_MAGIC) && equal(image.begin(), image.end(), FILE_MAGIC);
+    }
+
+public:
+    CatalogJournal() = default;
+    ~CatalogJournal() { Close(); }
+
+    CatalogJournal(const CatalogJournal&) = delete;
+    CatalogJournal& operator=(const CatalogJournal&) = delete;
+
+    // Recovery: replays the log at path onto tree (already loaded from the base
+    // file), cuts off any torn tail and opens the log for appending. A file at
+    // path that is not a journal is left untouched and the journal stays closed.
+    // Returns the number of records replayed; check IsOpen for failure.
+    size_t Open(const string& path, BinarySearchTree& tree) {
+        Close();
+        logPath = path;
+        vector<char> image = readImage(path);
+        size_t validBytes = 0;
+        size_t records = replayImage(image, tree, validBytes);
+
+        bool ok;
+        if (validBytes == 0) {
+            if (!isUnstartedLog(path, image)) {
+                cout << "Journal " << path << " does not start with a journal header; left it as is. "
+                     << "Move it aside to journal new edits." << endl;
+                return records;
+            }
+            ok = createEmptyLog();
+        }
+        else {
+            if (validBytes < image.size()) {
+                cout << "Journal " << path << ": discarded " << image.size() - validBytes
+                     << " bytes after the last complete record." << endl;
+                error_code ec;
+                filesystem::resize_file(path, validBytes, ec);
+            }
+            file = openFile(path, "ab");
+            fileBytes = validBytes;
+            ok = file != nullptr;
+        }
+        if (!ok) {
+            cout << "Could not open journal (" << path << ")." << endl;
+            if (file) fclose(file);
+            file = nullptr;
+            return records;
+        }
+        writeFailed = false;
+        flusher = thread(&CatalogJournal::flushLoop, this);
+        return records;
+    }
+
+    bool IsOpen() const { return file != nullptr; }
+
+    // Appends an operation and returns its sequence number for WaitDurable.
+    // Log the operation as it is applied to the tree, and report it done only
+    // after WaitDurable; 0 means the journal is closed.
+    uint64_t LogInsert(const Course& course) {
+        string row;
+        appendCsvRow(row, course);
+        return append(JOURNAL_INSERT, row);
+    }
+
+    uint64_t LogDelete(const string& courseNumber) {
+        return append(JOURNAL_DELETE, courseNumber);
+    }
+
+    // Blocks until record lsn (and everything before it) is on disk
+    bool WaitDurable(uint64_t lsn) {
+        unique_lock<mutex> guard(lock);
+        durable.wait(guard, [&] { return durableLsn >= lsn || writeFailed || !file; });
+        if (writeFailed) cout << "Journal write failed (" << logPath << ")." << endl;
+        return !writeFailed && file;
+    }
+
+    bool Flush() {
+        uint64_t lsn;
+        {
+            lock_guard<mutex> guard(lock);
+            lsn = bufferedLsn;
+        }
+        return WaitDurable(lsn);
+    }
+
+    // Re-applies the whole log, e.g. after the base file was reloaded
+    size_t Replay(BinarySearchTree& tree) {
+        if (!file || !Flush()) return 0;
+        size_t validBytes = 0;
+        return replayImage(readImage(logPath), tree, validBytes);
+    }
+
+    bool NeedsCompaction() {
+        lock_guard<mutex> guard(lock);
+        return file && fileBytes + pending.size() > COMPACT_BYTES;
+    }
+
+    // Writes tree in key order to a new base file, atomically replaces basePath
+    // with it and starts an empty log. A crash before the log is reset is safe:
+    // replaying a log over the base it was folded into gives the same catalog.
+    // No edits may be logged while this runs.
+    bool Compact(BinarySearchTree& tree, const string& basePath) {
+        if (!file || !Flush()) return false;
+        tree.DetachSource(); // the old base is about to be replaced
+
+        string tmpPath = basePath + ".tmp";
+        FILE* out = openFile(tmpPath, "wb");
+        bool ok = out != nullptr;
+        string buffer;
+        buffer.reserve(1 << 20);
+        tree.ForEach([&](const Course& c) {
+            appendCsvRow(buffer, c);
+            buffer += '\n';
+            if (buffer.size() >= (1 << 20)) {
+                ok = ok && fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+                buffer.clear();
+            }
+        });
+        ok = ok && fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size() && syncFile(out);
+        if (out) fclose(out);
+        error_code ec;
+        if (ok) filesystem::rename(tmpPath, basePath, ec);
+        if (!ok || ec) {
+            cout << "Could not write compacted catalog (" << basePath << ")." << endl;
+            filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        syncDirectory(basePath);
+
+        lock_guard<mutex> guard(lock);
+        fclose(file);
+        if (!createEmptyLog()) {
+            cout << "Could not reset journal (" << logPath << ")." << endl;
+            writeFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Flushes outstanding records and stops the flusher
+    void Close() {
+        if (flusher.joinable()) {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            wakeFlusher.notify_one();
+            flusher.join();
+        }
+        if (file) fclose(file);
+        file = nullptr;
+        stopping = false;
+        pending.clear();
+        nextLsn = 1;
+        bufferedLsn = durableLsn = 0;
+    }
+};
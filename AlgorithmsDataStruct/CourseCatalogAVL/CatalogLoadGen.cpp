@@ -0,0 +1,172 @@
+//============================================================================
+// Name        : CatalogLoadGen.cpp
+// Author      : Sonny Coutu
+// Description : Load-generating client for the catalog server
+//               (CourseCatalogAVL --serve). Each connection sends pipelined
+//               batches of find/prefix/prerequisite requests and waits for the
+//               whole batch; throughput and batch latency are reported.
+//               Usage: CatalogLoadGen [socketPath] [courses.csv] [connections]
+//                                     [requestsPerConnection] [pipelineDepth]
+//============================================================================
+
+#include "CatalogServer.h"
+
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+#ifdef __linux__
+
+// Blocking helpers: the client only ever waits for one thing at a time
+bool writeAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readExact(int fd, char* buffer, size_t count) {
+    size_t got = 0;
+    while (got < count) {
+        ssize_t n = read(fd, buffer + got, count - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int connectTo(const string& socketPath) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+    if (fd >= 0) close(fd);
+    return -1;
+}
+
+struct ClientStats {
+    long long requests = 0;
+    long long notFound = 0;
+    long long responseBytes = 0;
+    vector<double> batchMicros;     // Round-trip time of each pipelined batch
+    bool failed = false;
+};
+
+// One connection's worth of traffic: 80% find, 10% prefix, 10% prerequisite chain
+void runClient(const string& socketPath, const vector<string>& keys, int requestCount,
+               int depth, unsigned seed, ClientStats& stats) {
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        stats.failed = true;
+        return;
+    }
+    mt19937 rng(seed);
+    string batch, payload, body;
+
+    for (int done = 0; done < requestCount; done += depth) {
+        int inBatch = min(depth, requestCount - done);
+        batch.clear();
+        for (int i = 0; i < inBatch; ++i) {
+            const string& key = keys[rng() % keys.size()];
+            unsigned pick = rng() % 10;
+            payload.assign(1, pick < 8 ? OP_FIND : pick < 9 ? OP_PREFIX : OP_PREREQS);
+            payload += pick == 8 ? key.substr(0, key.size() - 2) : key; // prefix requests drop the last two digits
+            appendFrameLength(batch, static_cast<uint32_t>(payload.size()));
+            batch += payload;
+        }
+
+        auto start = chrono::steady_clock::now();
+        if (!writeAll(fd, batch)) {
+            stats.failed = true;
+            break;
+        }
+        for (int i = 0; i < inBatch; ++i) {
+            char header[4];
+            if (!readExact(fd, header, 4)) {
+                stats.failed = true;
+                break;
+            }
+            uint32_t length = readFrameLength(header);
+            body.resize(length);
+            if (length == 0 || !readExact(fd, &body[0], length)) {
+                stats.failed = true;
+                break;
+            }
+            stats.notFound += body[0] == STATUS_NOT_FOUND;
+            stats.responseBytes += 4 + length;
+        }
+        if (stats.failed) break;
+        stats.batchMicros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        stats.requests += inBatch;
+    }
+    close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    string socketPath = argc > 1 ? argv[1] : "/tmp/course_catalog.sock";
+    string filePath = argc > 2 ? argv[2] : "courses.csv";
+    int connections = argc > 3 ? max(1, atoi(argv[3])) : 4;
+    int requestsPerConnection = argc > 4 ? max(1, atoi(argv[4])) : 100000;
+    int depth = argc > 5 ? max(1, atoi(argv[5])) : 32;
+
+    // Request keys come from the same CSV the server loaded, plus 10% misspelled IDs
+    BinarySearchTree courseList;
+    loadCourses(filePath, &courseList);
+    vector<string> keys;
+    courseList.ForEach([&keys](const Course& c) { keys.push_back(c.courseNumber); });
+    if (keys.empty()) {
+        cout << "No course IDs to request." << endl;
+        return 1;
+    }
+    size_t hits = keys.size();
+    for (size_t i = 0; i < hits / 10 + 1; ++i) keys.push_back(keys[i % hits] + "X");
+
+    vector<ClientStats> stats(connections);
+    vector<thread> clients;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < connections; ++i) {
+        clients.emplace_back(runClient, cref(socketPath), cref(keys), requestsPerConnection, depth,
+                             static_cast<unsigned>(i + 1), ref(stats[i]));
+    }
+    for (thread& t : clients) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    ClientStats total;
+    for (ClientStats& s : stats) {
+        total.requests += s.requests;
+        total.notFound += s.notFound;
+        total.responseBytes += s.responseBytes;
+        total.failed = total.failed || s.failed;
+        total.batchMicros.insert(total.batchMicros.end(), s.batchMicros.begin(), s.batchMicros.end());
+    }
+    if (total.failed) cout << "Warning: some connections failed (is the server running on " << socketPath << "?)" << endl;
+    if (total.batchMicros.empty()) return 1;
+
+    sort(total.batchMicros.begin(), total.batchMicros.end());
+    auto percentile = [&total](double p) {
+        return total.batchMicros[static_cast<size_t>(p * (total.batchMicros.size() - 1))];
+    };
+    cout << fixed << setprecision(1);
+    cout << connections << " connections x " << requestsPerConnection << " requests, pipeline depth " << depth << endl;
+    cout << "requests      " << total.requests << " (" << total.notFound << " not found)" << endl;
+    cout << "throughput    " << total.requests / seconds << " req/s, "
+         << total.responseBytes / seconds / (1024 * 1024) << " MiB/s" << endl;
+    cout << "batch latency p50 " << percentile(0.50) << " us, p99 " << percentile(0.99)
+         << " us, max " << total.batchMicros.back() << " us" << endl;
+    return 0;
+}
+
+#else
+
+int main() {
+    cout << "CatalogLoadGen requires Linux (Unix domain sockets with the epoll server)." << endl;
+    return 1;
+}
+
+#endif // __linux__
@@ -0,0 +1,323 @@
+//============================================================================
+// Name        : CatalogServer.h
+// Author      : Sonny Coutu
+// Description : Local query server for a loaded catalog. Clients connect over
+//               a Unix domain socket and send length-prefixed requests; a
+//               single-threaded epoll loop answers them. Requests may be
+//               pipelined, and every response produced from one read is
+//               flushed with a single send. A client may shut down its
+//               sending side after its last request and still read every
+//               answer before the server closes the connection.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <cstdint>
+#include <csignal>
+#include <functional>
+#include <set>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// ---------------- Wire protocol ----------------
+// Every frame is a 4-byte big-endian payload length followed by the payload.
+//   Request payload : 1 opcode byte, then the argument (course ID or prefix)
+//   Response payload: 1 status byte, then text with one course per line
+enum CatalogOp : char {
+    OP_FIND = 'F',      // Course line and its direct prerequisites
+    OP_PREFIX = 'P',    // Every course whose ID starts with the argument
+    OP_PREREQS = 'R',   // Full prerequisite chain, prerequisites before dependents
+    OP_DUMP = 'D'       // Entire catalog in key order (argument ignored)
+};
+
+enum CatalogStatus : char {
+    STATUS_OK = 'K',
+    STATUS_NOT_FOUND = 'N',
+    STATUS_BAD_REQUEST = 'E'
+};
+
+const uint32_t MAX_FRAME_BYTES = 1u << 20; // Larger requests close the connection
+
+inline void appendFrameLength(string& out, uint32_t length) {
+    out.push_back(static_cast<char>((length >> 24) & 0xFF));
+    out.push_back(static_cast<char>((length >> 16) & 0xFF));
+    out.push_back(static_cast<char>((length >> 8) & 0xFF));
+    out.push_back(static_cast<char>(length & 0xFF));
+}
+
+inline uint32_t readFrameLength(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) | (uint32_t(u[2]) << 8) | uint32_t(u[3]);
+}
+
+inline void appendCourseLine(string& out, const Course& c) {
+    out += c.courseNumber;
+    out += ", ";
+    out += c.courseName;
+    out += '\n';
+}
+
+// Post-order walk so each prerequisite is listed before the courses that need it
+inline void appendPrereqChain(const BinarySearchTree& catalog, const string& courseNumber,
+                              set<string>& visited, string& out) {
+    if (!visited.insert(courseNumber).second) return;
+    const Course* course = catalog.Find(courseNumber);
+    if (!course) {
+        out += courseNumber;
+        out += ", (not in catalog)\n";
+        return;
+    }
+    for (const string& pre : course->preReqs) appendPrereqChain(catalog, pre, visited, out);
+    appendCourseLine(out, *course);
+}
+
+// Answers one request payload by appending a response frame to out. The body is
+// formatted in place after a placeholder length that is patched at the end.
+inline void answerRequest(const BinarySearchTree& catalog, const char* payload, uint32_t length, string& out) {
+    size_t frameStart = out.size();
+    appendFrameLength(out, 0);
+    out.push_back(STATUS_OK);
+    size_t bodyStart = out.size();
+
+    string argument(payload + 1, length - 1);
+    convertCase(argument);
+    switch (payload[0]) {
+    case OP_FIND:
+        if (auto text = catalog.RenderCourse(argument)) out += *text;
+        break;
+    case OP_PREFIX:
+        catalog.ForEachPrefix(argument, [&out](const Course& c) { appendCourseLine(out, c); });
+        break;
+    case OP_PREREQS:
+        if (const Course* c = catalog.Find(argument)) {
+            set<string> visited{ c->courseNumber };
+            for (const string& pre : c->preReqs) appendPrereqChain(catalog, pre, visited, out);
+            if (out.size() == bodyStart) out += "none\n";
+        }
+        else out[bodyStart - 1] = STATUS_NOT_FOUND;
+        break;
+    case OP_DUMP:
+        catalog.ForEach([&out](const Course& c) { appendCourseLine(out, c); });
+        break;
+    default:
+        out[bodyStart - 1] = STATUS_BAD_REQUEST;
+        out += "unknown opcode\n";
+        break;
+    }
+    if (out.size() == bodyStart && out[bodyStart - 1] == STATUS_OK) out[bodyStart - 1] = STATUS_NOT_FOUND;
+
+    uint32_t frameLength = static_cast<uint32_t>(out.size() - bodyStart + 1);
+    string header;
+    appendFrameLength(header, frameLength);
+    out.replace(frameStart, 4, header);
+}
+
+#ifdef __linux__
+
+class CatalogServer {
+private:
+    static const int MAX_EVENTS = 64;
+    static const size_t READ_CHUNK = 64 * 1024;
+    static const size_t OUT_HIGH_WATER = 8 * 1024 * 1024; // Stop answering until the client drains
+
+    struct Connection {
+        string in;          // Bytes received but not yet parsed
+        size_t inPos = 0;   // Start of the first unparsed frame
+        string out;         // Responses not yet sent
+        size_t outPos = 0;  // First unsent byte
+        bool wantWrite = false; // Registered for EPOLLOUT
+        bool readClosed = false; // Client shut down its sending side; answer what it sent, then close
+    };
+
+    const BinarySearchTree& catalog;
+    string socketPath;
+    int listenFd;
+    int epollFd;
+    unordered_map<int, Connection> connections;
+
+    void closeConnection(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    void setWriteInterest(int fd, Connection& conn, bool enable) {
+        if (conn.wantWrite == enable) return;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (enable ? uint32_t(EPOLLOUT) : 0u);
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        conn.wantWrite = enable;
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN: backlog drained
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+            ev.data.fd = fd;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                close(fd);
+                continue;
+            }
+            connections[fd];
+        }
+    }
+
+    // Answers every complete frame in the input buffer; false on a protocol error
+    bool processInput(Connection& conn) {
+        while (conn.out.size() - conn.outPos < OUT_HIGH_WATER && conn.in.size() - conn.inPos >= 4) {
+            uint32_t length = readFrameLength(conn.in.data() + conn.inPos);
+            if (length == 0 || length > MAX_FRAME_BYTES) return false;
+            if (conn.in.size() - conn.inPos - 4 < length) break; // partial frame
+            answerRequest(catalog, conn.in.data() + conn.inPos + 4, length, conn.out);
+            conn.inPos += 4 + length;
+        }
+        if (conn.inPos > 0 && conn.inPos * 2 >= conn.in.size()) {
+            conn.in.erase(0, conn.inPos);
+            conn.inPos = 0;
+        }
+        return true;
+    }
+
+    // Sends as much pending output as the socket accepts; false if the peer is gone
+    bool flush(int fd, Connection& conn) {
+        while (conn.outPos < conn.out.size()) {
+            ssize_t n = send(fd, conn.out.data() + conn.outPos, conn.out.size() - conn.outPos, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    setWriteInterest(fd, conn, true);
+                    return true;
+                }
+                if (errno == EINTR) continue;
+                return false;
+            }
+            conn.outPos += static_cast<size_t>(n);
+        }
+        conn.out.clear();
+        conn.outPos = 0;
+        setWriteInterest(fd, conn, false);
+        return true;
+    }
+
+    void handleEvent(int fd, uint32_t events) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        Connection& conn = it->second;
+        if (events & (EPOLLHUP | EPOLLERR)) { // nobody left to answer
+            closeConnection(fd);
+            return;
+        }
+
+        if ((events & (EPOLLIN | EPOLLRDHUP)) && !conn.readClosed) {
+            char buffer[READ_CHUNK];
+            while (true) {
+                ssize_t n = read(fd, buffer, sizeof(buffer));
+                if (n > 0) conn.in.append(buffer, static_cast<size_t>(n));
+                else if (n == 0) { conn.readClosed = true; break; }
+                else if (errno == EINTR) continue;
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                else {
+                    closeConnection(fd);
+                    return;
+                }
+            }
+        }
+
+        // Answer everything received, then flush it in one batch; repeat while
+        // flushing frees room under the high-water mark
+        while (true) {
+            if (!processInput(conn)) {
+                closeConnection(fd);
+                return;
+            }
+            size_t pendingBefore = conn.out.size() - conn.outPos;
+            if (!flush(fd, conn)) {
+                closeConnection(fd);
+                return;
+            }
+            bool drained = conn.out.empty() && pendingBefore > 0;
+            if (!drained || conn.in.size() - conn.inPos < 4) break;
+        }
+        // Output left over means the socket is full or frames wait under the
+        // high-water mark; EPOLLOUT brings the connection back here
+        if (conn.readClosed && conn.out.empty()) closeConnection(fd);
+    }
+
+public:
+    CatalogServer(const BinarySearchTree& aCatalog, const string& path)
+        : catalog(aCatalog), socketPath(path), listenFd(-1), epollFd(-1) {}
+
+    ~CatalogServer() {
+        for (auto& entry : connections) close(entry.first);
+        if (epollFd >= 0) close(epollFd);
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(socketPath.c_str());
+        }
+    }
+
+    CatalogServer(const CatalogServer&) = delete;
+    CatalogServer& operator=(const CatalogServer&) = delete;
+
+    // Binds and listens on the socket path; prints the reason and returns false on failure
+    bool Start() {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path)) {
+            cout << "Socket path too long (" << socketPath << ")." << endl;
+            return false;
+        }
+        strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socketPath.c_str()); // stale socket from a previous run
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+            || listen(listenFd, SOMAXCONN) < 0) {
+            cout << "Could not listen on " << socketPath << ": " << strerror(errno) << endl;
+            return false;
+        }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) < 0) {
+            cout << "Could not create event loop: " << strerror(errno) << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Serves clients until stopRequested becomes nonzero (e.g. from a signal handler).
+    // betweenBatches runs on the loop thread after every wakeup, at least twice a
+    // second, and may modify the catalog since no request is in flight.
+    void Run(const volatile sig_atomic_t& stopRequested, const function<void()>& betweenBatches = nullptr) {
+        epoll_event events[MAX_EVENTS];
+        while (!stopRequested) {
+            if (betweenBatches) betweenBatches();
+            int n = epoll_wait(epollFd, events, MAX_EVENTS, 500);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                cout << "epoll_wait failed: " << strerror(errno) << endl;
+                return;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.fd == listenFd) acceptClients();
+                else handleEvent(events[i].data.fd, events[i].events);
+            }
+        }
+    }
+};
+
+#endif // __linux__
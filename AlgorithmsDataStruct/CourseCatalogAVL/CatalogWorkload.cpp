@@ -0,0 +1,96 @@
+//============================================================================
+// Name        : CatalogWorkload.cpp
+// Author      : Sonny Coutu
+// Description : Replays catalog workload traces (see WorkloadTrace.h) against
+//               the AVL tree and reports throughput and tail latency.
+//               Usage: CatalogWorkload replay trace.txt
+//                      CatalogWorkload synth courses.csv [operations]
+//                          [readPercent] [uniform|zipf[:s]|hotspot[:keys:share]]
+//                          [seed] [saveTrace.txt]
+//============================================================================
+
+#include "WorkloadTrace.h"
+
+#include <iomanip>
+
+string opName(char op) {
+    switch (op) {
+    case 'L': return "load";
+    case 'F': return "find";
+    case 'I': return "insert";
+    case 'D': return "delete";
+    case 'M': return "merge";
+    case 'T': return "traverse";
+    default: return string(1, op);
+    }
+}
+
+void printResult(ReplayResult& result) {
+    // Throughput leaves out whole-file loads and merges, which would swamp it
+    size_t bulkOps = 0;
+    double bulkSeconds = 0;
+    for (char op : { 'L', 'M' }) {
+        if (!result.byOp.count(op)) continue;
+        bulkOps += result.byOp[op].nanos.size();
+        for (double nanos : result.byOp[op].nanos) bulkSeconds += nanos / 1e9;
+    }
+    double steadySeconds = result.seconds - bulkSeconds;
+    cout << result.operations << " operations in " << fixed << setprecision(3) << result.seconds << " s, "
+         << setprecision(0) << (steadySeconds > 0 ? (result.operations - bulkOps) / steadySeconds : 0.0)
+         << " ops/s excluding loads and merges" << endl;
+    if (result.skipped) cout << result.skipped << " trace lines with an unknown operation were skipped" << endl;
+    cout << left << setw(10) << "op" << right << setw(10) << "count" << setw(10) << "misses"
+         << setw(12) << "p50 ns" << setw(12) << "p99 ns" << setw(12) << "p99.9 ns" << setw(14) << "max ns" << endl;
+    for (auto& entry : result.byOp) {
+        OpLatencies& op = entry.second;
+        cout << left << setw(10) << opName(entry.first) << right << setw(10) << op.nanos.size() << setw(10) << op.misses
+             << setprecision(0) << setw(12) << op.Percentile(0.50) << setw(12) << op.Percentile(0.99)
+             << setw(12) << op.Percentile(0.999) << setw(14) << op.Percentile(1.0) << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "replay" && argc == 3) {
+        vector<TraceEntry> trace;
+        if (!readTrace(argv[2], trace)) return 1;
+        BinarySearchTree catalog;
+        ReplayResult result = replayTrace(trace, catalog);
+        printResult(result);
+        return 0;
+    }
+
+    if (mode == "synth" && argc >= 3 && argc <= 8) {
+        string csvPath = argv[2];
+        size_t operations = argc > 3 ? static_cast<size_t>(max(1LL, atoll(argv[3]))) : 1000000;
+        double readRatio = argc > 4 ? min(100.0, max(0.0, atof(argv[4]))) / 100 : 0.95;
+        KeyDistribution dist;
+        if (argc > 5 && !KeyDistribution::Parse(argv[5], dist)) {
+            cout << "Unknown key distribution (" << argv[5] << ")." << endl;
+            return 1;
+        }
+        uint64_t seed = argc > 6 ? strtoull(argv[6], nullptr, 10) : 42;
+
+        BinarySearchTree source;
+        loadCourses(csvPath, &source);
+        vector<Course> courses;
+        source.ForEach([&courses](const Course& c) { courses.push_back(c); });
+        if (courses.empty()) {
+            cout << "No courses to generate a workload from." << endl;
+            return 1;
+        }
+        vector<TraceEntry> trace = generateWorkload(csvPath, courses, operations, readRatio, dist, seed);
+        if (argc > 7 && !writeTrace(argv[7], trace)) return 1;
+
+        BinarySearchTree catalog;
+        ReplayResult result = replayTrace(trace, catalog);
+        printResult(result);
+        return 0;
+    }
+
+    cout << "Usage: CatalogWorkload replay trace.txt" << endl;
+    cout << "       CatalogWorkload synth courses.csv [operations] [readPercent]" << endl;
+    cout << "                             [uniform|zipf[:s]|hotspot[:keys:share]] [seed] [saveTrace.txt]" << endl;
+    return 1;
+}
@@ -0,0 +1,1662 @@
+//============================================================================
+// Name        : CourseCatalog.h
+// Author      : Sonny Coutu
+// Description : Course record, AVL BinarySearchTree, persistent snapshot
+//               tree and CSV loading shared by the catalog executables.
+//============================================================================
+
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cctype>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <map>
+#include <future>
+#include <thread>
+#include <span>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <string_view>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include "BlockedBloomFilter.h"
+#include "CsvScanner.h"
+#include "HotCourseCache.h"
+#include "PerfTrace.h"
+#include "WorkStealingPool.h"
+
+using namespace std; // using namespace as this is a small project without external non-standard library
+
+// Hint the CPU to start pulling p into cache; a no-op where unsupported
+inline void prefetchRead(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// Data structure representing a course and its prerequisites
+struct Course {
+    string courseNumber;       // e.g., "CSCI101"
+    string courseName;         // e.g., "Introduction to Programming in C++"
+    vector<string> preReqs;    // List of prerequisite course IDs
+};
+
+// A course as the menu and the server show it: "ID, Name" and its prerequisite line
+inline string formatCourse(const Course& aCourse) {
+    string text = aCourse.courseNumber + ", " + aCourse.courseName + "\nPrerequisites: ";
+    if (aCourse.preReqs.empty()) text += "none";
+    for (size_t i = 0; i < aCourse.preReqs.size(); ++i) {
+        if (i) text += ", ";
+        text += aCourse.preReqs[i];
+    }
+    text += '\n';
+    return text;
+}
+
+// Department prefix of a course ID: its leading letters ("CSCI" for "CSCI101")
+inline string_view departmentOf(string_view courseNumber) {
+    size_t letters = 0;
+    while (letters < courseNumber.size() && isalpha(static_cast<unsigned char>(courseNumber[letters]))) ++letters;
+    return courseNumber.substr(0, letters);
+}
+
+// False while the characters fit in the string's own small-string buffer
+inline bool stringOnHeap(const string& s) {
+    const char* object = reinterpret_cast<const char*>(&s);
+    return less<const char*>()(s.data(), object) || !less<const char*>()(s.data(), object + sizeof(string));
+}
+
+// FNV-1a digest of a course's name and prerequisites. A reload compares these
+// instead of the fields themselves, so unchanged rows are never copied.
+struct ContentHash {
+    uint64_t value = 14695981039346656037ull;
+
+    void Add(string_view text) {
+        for (unsigned char c : text) {
+            value ^= c;
+            value *= 1099511628211ull;
+        }
+        value ^= 0x1f; // field separator, so "AB","C" differs from "A","BC"
+        value *= 1099511628211ull;
+    }
+};
+
+inline uint64_t courseContentHash(const Course& c) {
+    ContentHash h;
+    h.Add(c.courseName);
+    for (const string& pre : c.preReqs) h.Add(pre);
+    return h.value;
+}
+
+// Digest of a whole course, ID included, for content-hashed trees. The FNV
+// value is scrambled (splitmix64 finalizer) so that sums of digests behave
+// like sums of independent random values.
+inline uint64_t courseDigest(const Course& c) {
+    ContentHash h;
+    h.Add(c.courseNumber);
+    h.Add(c.courseName);
+    for (const string& pre : c.preReqs) h.Add(pre);
+    uint64_t z = h.value;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Same digest for a parsed CSV row (ID, name, prerequisites...)
+inline uint64_t rowContentHash(const vector<string_view>& fields) {
+    ContentHash h;
+    h.Add(fields[1]);
+    for (size_t i = 2; i < fields.size(); ++i) {
+        if (!fields[i].empty()) h.Add(fields[i]);
+    }
+    return h.value;
+}
+
+// Courses that differ between two catalogs, as IDs in key order
+struct ContentDiff {
+    vector<string> onlyHere;    // In this catalog but not the other
+    vector<string> onlyThere;   // In the other catalog but not this one
+    vector<string> changed;     // In both, with a different name or prerequisites
+    size_t rangesCompared = 0;  // Key ranges whose hash sums were compared
+
+    bool Empty() const { return onlyHere.empty() && onlyThere.empty() && changed.empty(); }
+};
+
+class BinarySearchTree {
+private:
+    // Tree node structure containing a course
+    struct Node {
+        Course course;
+        Node* left;     // Left subtree pointer
+        Node* right;    // Right subtree pointer
+        int height;     // Height of this subtree (used for balancing)
+        int count;      // Number of nodes in this subtree (used by split/join and parallel grain)
+        uint64_t courseHash = 0;    // courseDigest of this course (content-hashed trees only)
+        uint64_t subtreeHash = 0;   // Sum of courseHash over this subtree (content-hashed trees only)
+
+        Node(const Course& c) : course(c), left(nullptr), right(nullptr), height(1), count(1) {}
+    };
+
+    Node* root; // Root node of the AVL tree
+    int size;   // Number of courses in the tree
+
+    // Lazy loading: LoadIndex inserts ID-only courses and remembers where each
+    // row lives; the name and prerequisites are parsed on first read
+    struct RowLocation {
+        uint64_t offset;
+        size_t length;
+    };
+    mutable unordered_map<string, RowLocation> pendingRows; // IDs not yet parsed
+    mutable atomic<size_t> pendingCount{ 0 };               // Lock-free "anything pending?" check
+    mutable ifstream payloadFile;                           // Source file of a lazy load
+    mutable mutex payloadMutex;                             // Guards the three members above
+
+    // Fills in a course that is still pending from a lazy load
+    void materialize(const Course& course) const {
+        if (pendingCount.load(memory_order_acquire) == 0) return;
+        lock_guard<mutex> lock(payloadMutex);
+        auto it = pendingRows.find(course.courseNumber);
+        if (it == pendingRows.end()) return;
+        TRACE_SAMPLED_SCOPE(span, "materialize", "lazy");
+
+        string row(it->second.length, '\0');
+        payloadFile.clear();
+        payloadFile.seekg(static_cast<streamoff>(it->second.offset));
+        payloadFile.read(&row[0], static_cast<streamsize>(row.size()));
+        vector<string_view> fields;
+        if (payloadFile.gcount() == static_cast<streamsize>(row.size())) splitRow(row, fields);
+        if (fields.empty() || fields[0] != course.courseNumber) {
+            // The file was edited after LoadIndex. Give up on this row rather than
+            // re-read it on every access; the next Reload sees the course as changed.
+            cout << "Course " << course.courseNumber << " moved in its source file since it was indexed; "
+                 << "reload the catalog to read it." << endl;
+            pendingRows.erase(it);
+            pendingCount.store(pendingRows.size(), memory_order_release);
+            return;
+        }
+        Course& target = const_cast<Course&>(course); // nodes are never const objects
+        if (fields.size() > 1) target.courseName = string(fields[1]);
+        for (size_t i = 2; i < fields.size(); ++i) {
+            if (!fields[i].empty()) target.preReqs.emplace_back(fields[i]);
+        }
+        pendingRows.erase(it);
+        pendingCount.store(pendingRows.size(), memory_order_release);
+    }
+
+    void materializeRec(const Node* node) const {
+        if (!node) return;
+        materializeRec(node->left);
+        materialize(node->course);
+        materializeRec(node->right);
+    }
+
+    // Parses every pending course; used before nodes move to another tree
+    void materializeAll() const {
+        if (pendingCount.load(memory_order_acquire) > 0) materializeRec(root);
+    }
+
+    // Node lookup and in-order walk that leave pending courses unparsed
+    Node* findNode(const string& courseNumber) const {
+        Node* node = root;
+        while (node && node->course.courseNumber != courseNumber) {
+            node = courseNumber < node->course.courseNumber ? node->left : node->right;
+        }
+        return node;
+    }
+
+    template <typename Visitor>
+    void forEachNodeRec(const Node* node, Visitor& visit) const {
+        if (!node) return;
+        forEachNodeRec(node->left, visit);
+        visit(node->course);
+        forEachNodeRec(node->right, visit);
+    }
+
+    template <typename Visitor>
+    void forEachNodeBlockRec(const Node* node, Visitor& visit) const {
+        if (!node) return;
+        forEachNodeBlockRec(node->left, visit);
+        visit(static_cast<const void*>(node), sizeof(Node), node->course);
+        forEachNodeBlockRec(node->right, visit);
+    }
+
+    // Optional Bloom filter over every ID in the tree: a lookup for an absent ID
+    // usually ends after one cache line instead of a full root-to-leaf walk.
+    // Deleted IDs stay set until the next rebuild, which happens once they
+    // make up a quarter of the tree and after every bulk operation.
+    BlockedBloomFilter missFilter;
+    bool filterEnabled = false;
+    size_t filterStaleDeletes = 0;
+
+    void rebuildFilter() {
+        if (!filterEnabled) return;
+        missFilter.Reset(static_cast<size_t>(size) * 3 / 2 + 64); // room to grow before the next rebuild
+        auto add = [this](const Course& c) { missFilter.Add(c.courseNumber); };
+        forEachNodeRec(root, add);
+        filterStaleDeletes = 0;
+    }
+
+    void filterAdded(const string& courseNumber) {
+        if (!filterEnabled) return;
+        if (static_cast<size_t>(size) > missFilter.Capacity()) rebuildFilter(); // keep false positives near 1%
+        else missFilter.Add(courseNumber);
+    }
+
+    void filterDeleted() {
+        if (filterEnabled && ++filterStaleDeletes > static_cast<size_t>(size) / 4 + 16) rebuildFilter();
+    }
+
+    bool filterRejects(string_view courseNumber) const {
+        return filterEnabled && !missFilter.MayContain(courseNumber);
+    }
+
+    // Optional cache of formatted courses for RenderCourse. Insert and Delete
+    // drop the entry for their ID; bulk operations drop every entry.
+    mutable HotCourseCache hotCache;
+
+    void afterBulkChange() {
+        rebuildFilter();
+        if (hotCache.Enabled()) hotCache.Clear();
+    }
+
+    void forgetPending(const string& courseNumber) {
+        if (pendingCount.load(memory_order_acquire) == 0) return;
+        lock_guard<mutex> lock(payloadMutex);
+        pendingRows.erase(courseNumber);
+        pendingCount.store(pendingRows.size(), memory_order_release);
+    }
+
+    // Forgets every pending row and closes their file, once the nodes they
+    // belong to are gone; otherwise a course moved in later under the same ID
+    // would be filled in from the old file
+    void dropPending() {
+        lock_guard<mutex> lock(payloadMutex);
+        pendingRows.clear();
+        pendingCount.store(0, memory_order_release);
+        payloadFile.close();
+    }
+
+    // Content hashes (Merkle mode): every node also carries the sum of its
+    // subtree's course digests. Sums rather than nested hashes, so two trees
+    // holding the same courses agree however they happen to be balanced, and
+    // a rotation only re-adds the nodes it moves. Off by default; while on,
+    // no course is left pending from a lazy load, since it has nothing to hash.
+    bool hashesEnabled = false;
+
+    static uint64_t nodeHash(const Node* n) { return n ? n->subtreeHash : 0; }
+
+    Node* newNode(const Course& c) {
+        Node* node = new Node(c);
+        if (hashesEnabled) node->courseHash = node->subtreeHash = courseDigest(c);
+        return node;
+    }
+
+    // Recomputes every digest in the subtree (after hashes are turned on)
+    void rehashRec(Node* node) {
+        if (!node) return;
+        rehashRec(node->left);
+        rehashRec(node->right);
+        node->courseHash = courseDigest(node->course);
+        updateHeight(node);
+    }
+
+    // Refreshes subtree hashes on the path to a course changed in place
+    void rehashPathRec(Node* node, const string& courseNumber) {
+        if (!node) return;
+        if (courseNumber < node->course.courseNumber) rehashPathRec(node->left, courseNumber);
+        else if (courseNumber > node->course.courseNumber) rehashPathRec(node->right, courseNumber);
+        else node->courseHash = courseDigest(node->course);
+        updateHeight(node);
+    }
+
+    // Digest sum and number of courses in part of the key range
+    struct RangeSummary {
+        uint64_t hash = 0;
+        int count = 0;
+    };
+
+    // Courses with ID < key, or <= key when inclusive
+    RangeSummary summaryBelow(const string& key, bool inclusive) const {
+        RangeSummary s;
+        for (const Node* node = root; node;) {
+            const string& id = node->course.courseNumber;
+            if (id < key || (inclusive && id == key)) {
+                s.hash += nodeHash(node->left) + node->courseHash;
+                s.count += nodeCount(node->left) + 1;
+                node = node->right;
+            }
+            else node = node->left;
+        }
+        return s;
+    }
+
+    // Courses with lo < ID < hi; a null bound is open
+    RangeSummary summaryBetween(const string* lo, const string* hi) const {
+        RangeSummary s = hi ? summaryBelow(*hi, false) : RangeSummary{ nodeHash(root), nodeCount(root) };
+        if (lo) {
+            RangeSummary below = summaryBelow(*lo, true);
+            s.hash -= below.hash;
+            s.count -= below.count;
+        }
+        return s;
+    }
+
+    // Appends, in key order, the IDs in the subtree with lo < ID < hi
+    static void collectRangeRec(const Node* node, const string* lo, const string* hi, vector<string>& ids) {
+        if (!node) return;
+        const string& id = node->course.courseNumber;
+        bool aboveLo = !lo || *lo < id;
+        bool belowHi = !hi || id < *hi;
+        if (aboveLo) collectRangeRec(node->left, lo, hi, ids);
+        if (aboveLo && belowHi) ids.push_back(id);
+        if (belowHi) collectRangeRec(node->right, lo, hi, ids);
+    }
+
+    // Helper: Returns node height (0 if null)
+    int nodeHeight(Node* n) { return n ? n->height : 0; }
+
+    // Helper: Returns subtree node count (0 if null)
+    static int nodeCount(const Node* n) { return n ? n->count : 0; }
+
+    // Updates height (and subtree count) after insert/delete/rotation
+    void updateHeight(Node* n) {
+        if (!n) return;
+        n->height = 1 + max(nodeHeight(n->left), nodeHeight(n->right));
+        n->count = 1 + nodeCount(n->left) + nodeCount(n->right);
+        if (hashesEnabled) n->subtreeHash = n->courseHash + nodeHash(n->left) + nodeHash(n->right);
+    }
+
+    // Calculates balance factor for AVL balancing
+    int balanceFactor(Node* n) { return n ? nodeHeight(n->left) - nodeHeight(n->right) : 0; }
+
+    // Performs right rotation to maintain AVL balance
+    Node* rotateRight(Node* y) {
+        TRACE_COUNT(ROTATIONS);
+        Node* x = y->left;
+        Node* T2 = x->right;
+        x->right = y;
+        y->left = T2;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    // Performs left rotation to maintain AVL balance
+    Node* rotateLeft(Node* x) {
+        TRACE_COUNT(ROTATIONS);
+        Node* y = x->right;
+        Node* T2 = y->left;
+        y->left = x;
+        x->right = T2;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    // Recursive insert function maintaining AVL balance
+    Node* insertRec(Node* node, const Course& c, bool& inserted) {
+        if (!node) {
+            inserted = true;
+            return newNode(c);
+        }
+
+        // Traverse to left or right subtree based on course number
+        TRACE_COUNT(DESCENTS);
+        if (c.courseNumber < node->course.courseNumber) {
+            node->left = insertRec(node->left, c, inserted);
+        }
+        else if (c.courseNumber > node->course.courseNumber) {
+            node->right = insertRec(node->right, c, inserted);
+        }
+        else {
+            inserted = false;
+            return node; // No duplicates allowed
+        }
+
+        // Update height and check for AVL balance
+        updateHeight(node);
+        int bf = balanceFactor(node);
+
+        // Perform necessary rotations (acceptable balance factor threshold is 0 or |1| )
+        if (bf > 1 && c.courseNumber < node->left->course.courseNumber) return rotateRight(node);
+        if (bf < -1 && c.courseNumber > node->right->course.courseNumber) return rotateLeft(node);
+        if (bf > 1 && c.courseNumber > node->left->course.courseNumber) {
+            node->left = rotateLeft(node->left);
+            return rotateRight(node);
+        }
+        if (bf < -1 && c.courseNumber < node->right->course.courseNumber) {
+            node->right = rotateRight(node->right);
+            return rotateLeft(node);
+        }
+
+        return node;
+    }
+
+    // Find node with smallest value in subtree
+    Node* minValueNode(Node* node) {
+        Node* current = node;
+        while (current && current->left) current = current->left;
+        return current;
+    }
+
+    // Recursive delete function maintaining AVL balance
+    Node* deleteRec(Node* root, const string& courseNumber, bool& deleted) {
+        if (!root) return root;
+
+        TRACE_COUNT(DESCENTS);
+        if (courseNumber < root->course.courseNumber) {
+            root->left = deleteRec(root->left, courseNumber, deleted);
+        }
+        else if (courseNumber > root->course.courseNumber) {
+            root->right = deleteRec(root->right, courseNumber, deleted);
+        }
+        else {
+            deleted = true;
+
+            // Node with one or no child
+            if (!root->left || !root->right) {
+                Node* temp = root->left ? root->left : root->right;
+                if (!temp) {
+                    temp = root;
+                    root = nullptr;
+                }
+                else *root = *temp;
+                delete temp;
+            }
+            else {
+                // Node with two children: get inorder successor
+                Node* temp = minValueNode(root->right);
+                root->course = temp->course;
+                root->courseHash = temp->courseHash;
+                root->right = deleteRec(root->right, temp->course.courseNumber, deleted);
+            }
+        }
+
+        if (!root) return root; 
+
+        // Update height and rebalance
+        updateHeight(root);
+        int bf = balanceFactor(root); 
+        
+        // acceptable threshold 0 or |1| again
+        if (bf > 1 && balanceFactor(root->left) >= 0) return rotateRight(root);
+        if (bf > 1 && balanceFactor(root->left) < 0) {
+            root->left = rotateLeft(root->left);
+            return rotateRight(root);
+        }
+        if (bf < -1 && balanceFactor(root->right) <= 0) return rotateLeft(root);
+        if (bf < -1 && balanceFactor(root->right) > 0) {
+            root->right = rotateRight(root->right);
+            return rotateLeft(root);
+        }
+
+        return root;
+    }
+
+    // Recursive search for a course by ID
+    Course searchRec(Node* node, const string& courseId) {
+        if (!node) return {};
+        if (node->course.courseNumber == courseId) {
+            materialize(node->course);
+            return node->course;
+        }
+        if (courseId < node->course.courseNumber) return searchRec(node->left, courseId);
+        return searchRec(node->right, courseId);
+    }
+
+    // Tree traversal functions
+    void inOrderRec(Node* node) {
+        if (!node) return;
+        inOrderRec(node->left);
+        materialize(node->course);
+        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
+        inOrderRec(node->right);
+    }
+
+    void preOrderRec(Node* node) {
+        if (!node) return;
+        materialize(node->course);
+        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
+        preOrderRec(node->left);
+        preOrderRec(node->right);
+    }
+
+    void postOrderRec(Node* node) {
+        if (!node) return;
+        postOrderRec(node->left);
+        postOrderRec(node->right);
+        materialize(node->course);
+        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
+    }
+
+    // In-order visit handing each course to a caller-supplied function
+    template <typename Visitor>
+    void forEachRec(const Node* node, Visitor& visit) const {
+        if (!node) return;
+        forEachRec(node->left, visit);
+        materialize(node->course);
+        visit(node->course);
+        forEachRec(node->right, visit);
+    }
+
+    // In-order visit restricted to IDs starting with prefix; skips subtrees
+    // that lie entirely before or after the matching key range
+    template <typename Visitor>
+    void forEachPrefixRec(const Node* node, const string& prefix, Visitor& visit) const {
+        if (!node) return;
+        const string& key = node->course.courseNumber;
+        bool matches = key.compare(0, prefix.size(), prefix) == 0;
+        if (key >= prefix) forEachPrefixRec(node->left, prefix, visit);
+        if (matches) {
+            materialize(node->course);
+            visit(node->course);
+        }
+        if (key < prefix || matches) forEachPrefixRec(node->right, prefix, visit);
+    }
+
+    // Deletes all nodes in the subtree (used in destructor)
+    void deleteSubtree(Node* node) {
+        if (!node) return;
+        deleteSubtree(node->left);
+        deleteSubtree(node->right);
+        delete node;
+    }
+
+    // Deep copy of a subtree (used when a set operation must not consume its argument)
+    Node* copySubtree(Node* node) {
+        if (!node) return nullptr;
+        Node* copy = newNode(node->course);
+        copy->left = copySubtree(node->left);
+        copy->right = copySubtree(node->right);
+        updateHeight(copy);
+        return copy;
+    }
+
+    // Builds a perfectly balanced subtree from sorted courses [lo, hi)
+    Node* buildRec(const vector<Course>& sorted, size_t lo, size_t hi) {
+        if (lo >= hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        Node* node = newNode(sorted[mid]);
+        node->left = buildRec(sorted, lo, mid);
+        node->right = buildRec(sorted, mid + 1, hi);
+        updateHeight(node);
+        return node;
+    }
+
+    // ---------------- Split / join primitives ----------------
+    // join(l, k, r) links two AVL trees through the middle node k, where every
+    // key in l < k < every key in r. Cost is O(|h(l) - h(r)| + 1).
+
+    // Attaches k and r along the right spine of the taller tree l
+    Node* joinRight(Node* l, Node* k, Node* r) {
+        Node* c = l->right;
+        if (nodeHeight(c) <= nodeHeight(r) + 1) {
+            k->left = c;
+            k->right = r;
+            updateHeight(k);
+            l->right = k;
+            if (nodeHeight(k) <= nodeHeight(l->left) + 1) {
+                updateHeight(l);
+                return l;
+            }
+            l->right = rotateRight(k);
+            updateHeight(l);
+            return rotateLeft(l);
+        }
+        l->right = joinRight(c, k, r);
+        updateHeight(l);
+        if (nodeHeight(l->right) <= nodeHeight(l->left) + 1) return l;
+        return rotateLeft(l);
+    }
+
+    // Mirror of joinRight for a taller right tree
+    Node* joinLeft(Node* l, Node* k, Node* r) {
+        Node* c = r->left;
+        if (nodeHeight(c) <= nodeHeight(l) + 1) {
+            k->left = l;
+            k->right = c;
+            updateHeight(k);
+            r->left = k;
+            if (nodeHeight(k) <= nodeHeight(r->right) + 1) {
+                updateHeight(r);
+                return r;
+            }
+            r->left = rotateLeft(k);
+            updateHeight(r);
+            return rotateRight(r);
+        }
+        r->left = joinLeft(l, k, c);
+        updateHeight(r);
+        if (nodeHeight(r->left) <= nodeHeight(r->right) + 1) return r;
+        return rotateRight(r);
+    }
+
+    Node* join(Node* l, Node* k, Node* r) {
+        if (nodeHeight(l) > nodeHeight(r) + 1) return joinRight(l, k, r);
+        if (nodeHeight(r) > nodeHeight(l) + 1) return joinLeft(l, k, r);
+        k->left = l;
+        k->right = r;
+        updateHeight(k);
+        return k;
+    }
+
+    // Detaches the largest node of a non-empty subtree into last
+    Node* splitLast(Node* node, Node*& last) {
+        if (!node->right) {
+            last = node;
+            Node* rest = node->left;
+            node->left = nullptr;
+            updateHeight(node);
+            return rest;
+        }
+        Node* left = node->left;
+        Node* rest = splitLast(node->right, last);
+        return join(left, node, rest);
+    }
+
+    // Joins two trees without a middle node (every key in l < every key in r)
+    Node* join2(Node* l, Node* r) {
+        if (!l) return r;
+        Node* last = nullptr;
+        Node* rest = splitLast(l, last);
+        return join(rest, last, r);
+    }
+
+    // Splits a subtree by key into keys < key (less), the matching node if any
+    // (found, detached), and keys > key (greater). Consumes the input subtree.
+    void splitRec(Node* node, const string& key, Node*& less, Node*& found, Node*& greater) {
+        if (!node) {
+            less = found = greater = nullptr;
+            return;
+        }
+        Node* left = node->left;
+        Node* right = node->right;
+        if (key == node->course.courseNumber) {
+            node->left = node->right = nullptr;
+            updateHeight(node);
+            less = left;
+            found = node;
+            greater = right;
+        }
+        else if (key < node->course.courseNumber) {
+            Node* lr = nullptr;
+            splitRec(left, key, less, found, lr);
+            greater = join(lr, node, right);
+        }
+        else {
+            Node* rl = nullptr;
+            splitRec(right, key, rl, found, greater);
+            less = join(left, node, rl);
+        }
+    }
+
+    // ---------------- Fork-join set operations ----------------
+    // Each operation splits the second tree by the first tree's root key and
+    // recurses on both halves, which are independent and run in parallel.
+    // Work is O(m log(n/m + 1)) and span O(log n log m) for sizes m <= n.
+
+    static const int PARALLEL_GRAIN = 2048; // Smallest subtree worth handing to another thread
+
+    // Runs left() and right(), concurrently when the subproblem is big enough
+    template <typename Left, typename Right>
+    void forkJoin(bool parallel, Left left, Right right) {
+        if (!parallel) {
+            left();
+            right();
+            return;
+        }
+        TaskGroup group;
+        group.Spawn(left);
+        right();
+        group.Wait();
+    }
+
+    // ---------------- Parallel visits ----------------
+    // Subtrees smaller than PARALLEL_GRAIN are walked on one thread; above it the
+    // left subtree is forked to the work-stealing pool. Every course's position
+    // in key order is offset + count(left), so results land at fixed indices.
+
+    template <typename Fn>
+    void parallelRankedRec(const Node* node, size_t offset, Fn& fn) const {
+        if (!node) return;
+        if (node->count < PARALLEL_GRAIN) {
+            auto visit = [&fn, &offset](const Course& c) { fn(c, offset++); };
+            forEachNodeRec(node, visit);
+            return;
+        }
+        size_t rank = offset + nodeCount(node->left);
+        TaskGroup group;
+        group.Spawn([this, node, offset, &fn] { parallelRankedRec(node->left, offset, fn); });
+        fn(node->course, rank);
+        parallelRankedRec(node->right, rank + 1, fn);
+        group.Wait();
+    }
+
+    // Folds left subtree, node, right subtree in that order, so the result
+    // matches a sequential in-order fold for any associative combine
+    template <typename T, typename Map, typename Combine>
+    T parallelReduceRec(const Node* node, const T& identity, Map& map, Combine& combine) const {
+        if (!node) return identity;
+        if (node->count < PARALLEL_GRAIN) {
+            T acc = identity;
+            auto visit = [&](const Course& c) { acc = combine(move(acc), map(c)); };
+            forEachNodeRec(node, visit);
+            return acc;
+        }
+        T left = identity;
+        TaskGroup group;
+        group.Spawn([&] { left = parallelReduceRec(node->left, identity, map, combine); });
+        T right = parallelReduceRec(node->right, identity, map, combine);
+        group.Wait();
+        return combine(combine(move(left), map(node->course)), move(right));
+    }
+
+    // Remaining fork depth for a fresh operation: enough to occupy every core
+    static int forkDepth() {
+        unsigned cores = max(1u, thread::hardware_concurrency());
+        int depth = 1;
+        while ((1u << depth) < cores) ++depth;
+        return depth + 1;
+    }
+
+    // Union of a and b; on duplicate keys the course from a is kept. Consumes both trees.
+    Node* unionRec(Node* a, Node* b, int depth) {
+        if (!a) return b;
+        if (!b) return a;
+        Node *less, *found, *greater;
+        splitRec(b, a->course.courseNumber, less, found, greater);
+        delete found;
+        Node* aLeft = a->left;
+        Node* aRight = a->right;
+        Node *left, *right;
+        forkJoin(depth > 0 && nodeCount(a) + nodeCount(less) + nodeCount(greater) >= PARALLEL_GRAIN,
+            [&] { left = unionRec(aLeft, less, depth - 1); },
+            [&] { right = unionRec(aRight, greater, depth - 1); });
+        return join(left, a, right);
+    }
+
+    // Intersection of a and b, keeping the courses from a. Consumes both trees.
+    Node* intersectRec(Node* a, Node* b, int depth) {
+        if (!a || !b) {
+            deleteSubtree(a);
+            deleteSubtree(b);
+            return nullptr;
+        }
+        Node *less, *found, *greater;
+        splitRec(b, a->course.courseNumber, less, found, greater);
+        Node* aLeft = a->left;
+        Node* aRight = a->right;
+        Node *left, *right;
+        forkJoin(depth > 0 && nodeCount(a) + nodeCount(less) + nodeCount(greater) >= PARALLEL_GRAIN,
+            [&] { left = intersectRec(aLeft, less, depth - 1); },
+            [&] { right = intersectRec(aRight, greater, depth - 1); });
+        if (found) {
+            delete found;
+            return join(left, a, right);
+        }
+        delete a;
+        return join2(left, right);
+    }
+
+    // Courses of a whose keys are not in b. Consumes both trees.
+    Node* differenceRec(Node* a, Node* b, int depth) {
+        if (!a || !b) {
+            deleteSubtree(b);
+            return a;
+        }
+        Node *less, *found, *greater;
+        splitRec(a, b->course.courseNumber, less, found, greater);
+        delete found;
+        Node* bLeft = b->left;
+        Node* bRight = b->right;
+        delete b;
+        Node *left, *right;
+        forkJoin(depth > 0 && nodeCount(less) + nodeCount(greater) >= PARALLEL_GRAIN,
+            [&] { left = differenceRec(less, bLeft, depth - 1); },
+            [&] { right = differenceRec(greater, bRight, depth - 1); });
+        return join2(left, right);
+    }
+
+    // One step of DiffContents over the courses with lo < ID < hi
+    void diffRangeRec(const BinarySearchTree& other, const string* lo, const string* hi, ContentDiff& diff) const {
+        ++diff.rangesCompared;
+        RangeSummary here = summaryBetween(lo, hi);
+        RangeSummary there = other.summaryBetween(lo, hi);
+        if (here.hash == there.hash && here.count == there.count) return;
+        if (here.count == 0 || there.count == 0) {
+            collectRangeRec(root, lo, hi, diff.onlyHere);
+            collectRangeRec(other.root, lo, hi, diff.onlyThere);
+            return;
+        }
+        // This tree's highest node in the range, so recursion depth is bounded by its height
+        const Node* pivot = root;
+        for (;;) {
+            const string& id = pivot->course.courseNumber;
+            if (lo && !(*lo < id)) pivot = pivot->right;
+            else if (hi && !(id < *hi)) pivot = pivot->left;
+            else break;
+        }
+        const string& key = pivot->course.courseNumber;
+        diffRangeRec(other, lo, &key, diff);
+        const Node* match = other.findNode(key);
+        if (!match) diff.onlyHere.push_back(key);
+        else if (match->courseHash != pivot->courseHash) diff.changed.push_back(key);
+        diffRangeRec(other, &key, hi, diff);
+    }
+
+    // Sorts by courseNumber and drops repeated keys, keeping the first occurrence
+    static void sortUnique(vector<Course>& courses) {
+        stable_sort(courses.begin(), courses.end(),
+            [](const Course& a, const Course& b) { return a.courseNumber < b.courseNumber; });
+        courses.erase(unique(courses.begin(), courses.end(),
+            [](const Course& a, const Course& b) { return a.courseNumber == b.courseNumber; }), courses.end());
+    }
+
+public:
+    BinarySearchTree() : root(nullptr), size(0) {}
+    ~BinarySearchTree() { deleteSubtree(root); }
+
+    // Public traversal wrappers
+    void InOrder() { inOrderRec(root); }
+    void PreOrder() { preOrderRec(root); }
+    void PostOrder() { postOrderRec(root); }
+
+    // Visit every course in key order without printing
+    template <typename Visitor>
+    void ForEach(Visitor visit) const { forEachRec(root, visit); }
+
+    // Pull-style in-order walk, one course per Next(); the tree must not be
+    // modified while a cursor over it is in use
+    class Cursor {
+    private:
+        const BinarySearchTree* tree;
+        vector<const Node*> path; // Nodes still to visit, next one last
+
+    public:
+        // Starts at the first course whose ID is not less than from
+        Cursor(const BinarySearchTree& aTree, const string& from) : tree(&aTree) {
+            for (const Node* node = aTree.root; node;) {
+                if (node->course.courseNumber < from) node = node->right;
+                else {
+                    path.push_back(node);
+                    node = node->left;
+                }
+            }
+        }
+
+        // Next course in key order, or nullptr once the walk is done
+        const Course* Next() {
+            if (path.empty()) return nullptr;
+            const Node* node = path.back();
+            path.pop_back();
+            for (const Node* n = node->right; n; n = n->left) path.push_back(n);
+            tree->materialize(node->course);
+            return &node->course;
+        }
+    };
+
+    Cursor Begin(const string& from = "") const { return Cursor(*this, from); }
+
+    // Visit, in key order, every course whose ID starts with prefix
+    template <typename Visitor>
+    void ForEachPrefix(const string& prefix, Visitor visit) const { forEachPrefixRec(root, prefix, visit); }
+
+    // Calls visit(course) for every course from several threads at once, in
+    // no particular order; visit must be safe to call concurrently
+    template <typename Visitor>
+    void ParallelForEach(Visitor visit) const {
+        materializeAll();
+        auto ranked = [&visit](const Course& c, size_t) { visit(c); };
+        parallelRankedRec(root, 0, ranked);
+    }
+
+    // map(course) for every course, returned in key order
+    template <typename Map>
+    auto ParallelMap(Map map) const {
+        materializeAll();
+        vector<decltype(map(declval<const Course&>()))> results(static_cast<size_t>(size));
+        auto ranked = [&](const Course& c, size_t rank) { results[rank] = map(c); };
+        parallelRankedRec(root, 0, ranked);
+        return results;
+    }
+
+    // Courses for which keep(course) is true, in key order
+    template <typename Predicate>
+    vector<const Course*> ParallelFilter(Predicate keep) const {
+        materializeAll();
+        vector<const Course*> marked(static_cast<size_t>(size), nullptr);
+        auto ranked = [&](const Course& c, size_t rank) { if (keep(c)) marked[rank] = &c; };
+        parallelRankedRec(root, 0, ranked);
+        marked.erase(remove(marked.begin(), marked.end(), nullptr), marked.end());
+        return marked;
+    }
+
+    // combine(...combine(combine(identity, map(first)), map(second))..., map(last))
+    // evaluated in parallel; deterministic for an associative combine, even a
+    // non-commutative one, since partial results are joined in key order
+    template <typename T, typename Map, typename Combine>
+    T ParallelReduce(T identity, Map map, Combine combine) const {
+        materializeAll();
+        return parallelReduceRec(root, identity, map, combine);
+    }
+
+    // Insert a course into the AVL tree
+    void Insert(const Course& aCourse) {
+        TRACE_SAMPLED_SCOPE(span, "insert", "tree");
+        bool inserted = false;
+        root = insertRec(root, aCourse, inserted);
+        if (inserted) {
+            ++size;
+            filterAdded(aCourse.courseNumber);
+            if (hotCache.Enabled()) hotCache.Invalidate(aCourse.courseNumber);
+        }
+    }
+
+    // Delete a course from the AVL tree
+    bool Delete(const string& courseNumber) {
+        TRACE_SAMPLED_SCOPE(span, "delete", "tree");
+        bool deleted = false;
+        root = deleteRec(root, courseNumber, deleted);
+        if (deleted) {
+            --size;
+            forgetPending(courseNumber);
+            filterDeleted();
+            if (hotCache.Enabled()) hotCache.Invalidate(courseNumber);
+        }
+        return deleted;
+    }
+
+    // Turns the negative-lookup filter on (built from the current tree) or off
+    void EnableMissFilter(bool enable) {
+        filterEnabled = enable;
+        if (enable) rebuildFilter();
+        else missFilter = BlockedBloomFilter();
+    }
+
+    bool MissFilterEnabled() const { return filterEnabled; }
+
+    // Caches up to capacity formatted courses for RenderCourse; 0 turns it off.
+    // Call while no other thread is using the tree.
+    void EnableHotCache(size_t capacity) { hotCache.Reset(capacity); }
+
+    HotCourseCache::Stats HotCacheStats() const { return hotCache.GetStats(); }
+
+    // Turns content hashes on (parsing any pending courses and hashing every
+    // course once) or off; while on, they are kept up to date by every change
+    void EnableContentHashes(bool enable) {
+        hashesEnabled = enable;
+        if (!enable) return;
+        materializeAll();
+        rehashRec(root);
+    }
+
+    bool ContentHashesEnabled() const { return hashesEnabled; }
+
+    // Sum of every course's digest; equal for trees with the same courses.
+    // 0 unless content hashes are enabled.
+    uint64_t RootHash() const { return hashesEnabled ? nodeHash(root) : 0; }
+
+    // With content hashes on in both trees, an O(1) comparison of sizes and
+    // root hashes (a false match needs a 64-bit digest collision); otherwise
+    // a walk over both trees
+    bool ContentEquals(const BinarySearchTree& other) const {
+        if (hashesEnabled && other.hashesEnabled) return size == other.size && nodeHash(root) == nodeHash(other.root);
+        return DiffContents(other).Empty();
+    }
+
+    // With content hashes on in both trees, compares the hash sums of key
+    // ranges, splitting a range at this tree's highest node inside it only
+    // when the sums differ. Work grows with the number of differing courses
+    // (about log^2 n range sums each), not with the catalog size. Otherwise
+    // falls back to a merge of two in-order walks.
+    ContentDiff DiffContents(const BinarySearchTree& other) const {
+        ContentDiff diff;
+        if (hashesEnabled && other.hashesEnabled) {
+            diffRangeRec(other, nullptr, nullptr, diff);
+            return diff;
+        }
+        Cursor here(*this, ""), there(other, "");
+        const Course* a = here.Next();
+        const Course* b = there.Next();
+        while (a || b) {
+            if (!b || (a && a->courseNumber < b->courseNumber)) {
+                diff.onlyHere.push_back(a->courseNumber);
+                a = here.Next();
+            }
+            else if (!a || b->courseNumber < a->courseNumber) {
+                diff.onlyThere.push_back(b->courseNumber);
+                b = there.Next();
+            }
+            else {
+                if (a->courseName != b->courseName || a->preReqs != b->preReqs) diff.changed.push_back(a->courseNumber);
+                a = here.Next();
+                b = there.Next();
+            }
+        }
+        return diff;
+    }
+
+    // Lazy load: a single pass records each row's ID and file position and bulk
+    // builds the tree from the IDs alone. Names and prerequisites are parsed the
+    // first time a course is displayed or queried. Rows whose ID is already in
+    // the tree are ignored, as with Insert. Returns false if the file can't be opened.
+    bool LoadIndex(const string& filePath) {
+        TRACE_SCOPE(span, "LoadIndex", "load");
+        materializeAll(); // rows pending from an earlier file must be read before it is replaced
+        lock_guard<mutex> lock(payloadMutex);
+        payloadFile.close();
+        payloadFile.clear();
+        payloadFile.open(filePath, ios::binary);
+        if (!payloadFile.is_open()) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return false;
+        }
+        ifstream inFS(filePath, ios::binary);
+        CsvReader reader(inFS);
+        vector<string_view> fields;
+        vector<Course> keys;
+        {
+            TRACE_SCOPE(scan, "scanRows", "load");
+            while (reader.NextRow(fields)) {
+                if (fields.size() < 2) continue;
+                string id(fields[0]);
+                if (root && Find(id)) continue;
+                if (hashesEnabled) { // parsed now: a pending course has no content to hash
+                    Course aCourse{ move(id), string(fields[1]), {} };
+                    for (size_t i = 2; i < fields.size(); ++i) {
+                        if (!fields[i].empty()) aCourse.preReqs.emplace_back(fields[i]);
+                    }
+                    keys.push_back(move(aCourse));
+                }
+                else if (pendingRows.emplace(id, RowLocation{ reader.RowOffset(), reader.RowLength() }).second) {
+                    keys.push_back(Course{ move(id), "", {} });
+                }
+            }
+            TRACE_ARG(scan, "rows", keys.size());
+        }
+        {
+            TRACE_SCOPE(build, "buildTree", "load");
+            sortUnique(keys);
+            root = unionRec(root, buildRec(keys, 0, keys.size()), forkDepth());
+        }
+        size = nodeCount(root);
+        pendingCount.store(pendingRows.size(), memory_order_release);
+        afterBulkChange();
+        return true;
+    }
+
+    // Number of courses whose name and prerequisites have not been parsed yet
+    size_t PendingCount() const { return pendingCount.load(memory_order_acquire); }
+
+    // Memory accounting (MemoryReport.h): visit(block, blockSize, course) for
+    // every node allocation in key order, leaving pending courses unparsed
+    template <typename Visitor>
+    void ForEachNodeBlock(Visitor visit) const { forEachNodeBlockRec(root, visit); }
+
+    // Approximate bytes held by the lazy-load row table: buckets, one list
+    // node per pending ID, and any ID too long for the inline string buffer
+    size_t PendingIndexBytes() const {
+        lock_guard<mutex> lock(payloadMutex);
+        size_t bytes = pendingRows.bucket_count() * sizeof(void*);
+        for (const auto& entry : pendingRows) {
+            bytes += sizeof(entry) + 2 * sizeof(void*);
+            if (stringOnHeap(entry.first)) bytes += entry.first.capacity() + 1;
+        }
+        return bytes;
+    }
+
+    size_t MissFilterBytes() const { return missFilter.Bytes(); }
+
+    // Parses every pending course and closes the source file, e.g. before it is replaced
+    void DetachSource() {
+        materializeAll();
+        lock_guard<mutex> lock(payloadMutex);
+        payloadFile.close();
+    }
+
+    // Changes needed to bring the tree in line with a new revision of its file
+    struct CatalogDiff {
+        string filePath;
+        bool ok = false;                              // File was read
+        vector<string> deleted;                       // IDs no longer in the file
+        vector<Course> inserted;                      // Rows with new IDs
+        vector<Course> updated;                       // Rows whose name or prerequisites changed
+        vector<pair<string, RowLocation>> relocated;  // Still-unparsed courses: their rows in the new file
+        size_t unchanged = 0;
+
+        bool Empty() const { return deleted.empty() && inserted.empty() && updated.empty(); }
+    };
+
+    // Sorted merge of the file against an in-order walk of the tree. Rows are
+    // compared by content hash, and only new or changed rows are parsed into
+    // courses. Read-only, so it can run on another thread while the tree keeps
+    // answering lookups; the tree must not be modified until ApplyDiff.
+    CatalogDiff DiffAgainst(const string& filePath) const {
+        TRACE_SCOPE(span, "DiffAgainst", "load");
+        CatalogDiff diff;
+        diff.filePath = filePath;
+        ifstream inFS(filePath, ios::binary);
+        ifstream rowFile(filePath, ios::binary);
+        if (!inFS.is_open() || !rowFile.is_open()) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return diff;
+        }
+
+        struct Row {
+            string id;
+            uint64_t hash;
+            RowLocation location;
+        };
+        vector<Row> rows;
+        CsvReader reader(inFS);
+        vector<string_view> fields;
+        while (reader.NextRow(fields)) {
+            if (fields.size() < 2) continue;
+            rows.push_back(Row{ string(fields[0]), rowContentHash(fields), { reader.RowOffset(), reader.RowLength() } });
+        }
+        // First occurrence of an ID wins, as when loading
+        stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.id < b.id; });
+        rows.erase(unique(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.id == b.id; }), rows.end());
+
+        string text;
+        auto parseRow = [&](const Row& row) {
+            text.resize(row.location.length);
+            rowFile.clear();
+            rowFile.seekg(static_cast<streamoff>(row.location.offset));
+            rowFile.read(&text[0], static_cast<streamsize>(text.size()));
+            splitRow(text, fields);
+            Course c{ row.id, string(fields.size() > 1 ? fields[1] : string_view()), {} };
+            for (size_t i = 2; i < fields.size(); ++i) {
+                if (!fields[i].empty()) c.preReqs.emplace_back(fields[i]);
+            }
+            return c;
+        };
+
+        lock_guard<mutex> lock(payloadMutex); // no course is materialized mid-comparison
+        size_t next = 0;
+        auto visit = [&](const Course& c) {
+            while (next < rows.size() && rows[next].id < c.courseNumber) diff.inserted.push_back(parseRow(rows[next++]));
+            if (next < rows.size() && rows[next].id == c.courseNumber) {
+                const Row& row = rows[next++];
+                if (pendingRows.count(c.courseNumber)) diff.relocated.emplace_back(row.id, row.location);
+                else if (courseContentHash(c) == row.hash) ++diff.unchanged;
+                else diff.updated.push_back(parseRow(row));
+            }
+            else diff.deleted.push_back(c.courseNumber);
+        };
+        forEachNodeRec(root, visit);
+        while (next < rows.size()) diff.inserted.push_back(parseRow(rows[next++]));
+        diff.ok = true;
+        return diff;
+    }
+
+    // Applies a diff from DiffAgainst. Courses deleted or parsed since the diff
+    // was taken are handled; unparsed courses now read from the new file.
+    void ApplyDiff(const CatalogDiff& diff) {
+        if (!diff.ok) return;
+        TRACE_SCOPE(span, "ApplyDiff", "load");
+        TRACE_ARG(span, "deleted", diff.deleted.size());
+        TRACE_ARG(span, "inserted", diff.inserted.size());
+        TRACE_ARG(span, "updated", diff.updated.size());
+        if (!diff.deleted.empty()) {
+            vector<Course> keys;
+            keys.reserve(diff.deleted.size());
+            for (const string& id : diff.deleted) {
+                keys.push_back(Course{ id, "", {} });
+                forgetPending(id);
+            }
+            root = differenceRec(root, buildRec(keys, 0, keys.size()), forkDepth());
+        }
+
+        // Overwrite in place when the course is present, otherwise insert
+        vector<Course> fresh;
+        auto upsert = [&](const Course& c) {
+            if (Node* node = findNode(c.courseNumber)) {
+                forgetPending(c.courseNumber);
+                node->course = c;
+                if (hashesEnabled) rehashPathRec(root, c.courseNumber);
+            }
+            else fresh.push_back(c);
+        };
+        for (const Course& c : diff.updated) upsert(c);
+        for (const Course& c : diff.inserted) upsert(c);
+        if (!fresh.empty()) {
+            sortUnique(fresh);
+            root = unionRec(root, buildRec(fresh, 0, fresh.size()), forkDepth());
+        }
+
+        if (!diff.relocated.empty()) {
+            vector<string> reparse; // parsed after the diff, so their contents are stale
+            {
+                lock_guard<mutex> lock(payloadMutex);
+                payloadFile.close();
+                payloadFile.clear();
+                payloadFile.open(diff.filePath, ios::binary);
+                for (const auto& entry : diff.relocated) {
+                    auto it = pendingRows.find(entry.first);
+                    if (it != pendingRows.end()) it->second = entry.second;
+                    else if (findNode(entry.first)) {
+                        pendingRows.emplace(entry.first, entry.second);
+                        reparse.push_back(entry.first);
+                    }
+                }
+                pendingCount.store(pendingRows.size(), memory_order_release);
+            }
+            for (const string& id : reparse) {
+                Node* node = findNode(id);
+                node->course.courseName.clear();
+                node->course.preReqs.clear();
+                materialize(node->course);
+            }
+        }
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Incremental reload: only inserts, deletes and updates reach the tree
+    CatalogDiff Reload(const string& filePath) {
+        CatalogDiff diff = DiffAgainst(filePath);
+        ApplyDiff(diff);
+        return diff;
+    }
+
+    // Moves every course with courseNumber >= key into upper, replacing its contents
+    void SplitAt(const string& courseNumber, BinarySearchTree& upper) {
+        if (&upper == this) return;
+        TRACE_SCOPE(span, "SplitAt", "bulk");
+        materializeAll();
+        Node *less, *found, *greater;
+        splitRec(root, courseNumber, less, found, greater);
+        deleteSubtree(upper.root);
+        upper.dropPending();
+        upper.root = found ? join(nullptr, found, greater) : greater;
+        if (upper.hashesEnabled && !hashesEnabled) upper.rehashRec(upper.root);
+        upper.size = nodeCount(upper.root);
+        upper.afterBulkChange();
+        root = less;
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Appends every course of upper, leaving it empty. When upper's keys do not
+    // all sort after this tree's keys, falls back to a union.
+    void Join(BinarySearchTree& upper) {
+        if (&upper == this || !upper.root) return;
+        TRACE_SCOPE(span, "Join", "bulk");
+        upper.materializeAll();
+        if (hashesEnabled && !upper.hashesEnabled) rehashRec(upper.root);
+        Node* maxNode = root;
+        while (maxNode && maxNode->right) maxNode = maxNode->right;
+        if (maxNode && !(maxNode->course.courseNumber < minValueNode(upper.root)->course.courseNumber)) {
+            root = unionRec(root, upper.root, forkDepth());
+        }
+        else root = join2(root, upper.root);
+        upper.root = nullptr;
+        upper.dropPending();
+        upper.size = 0;
+        upper.afterBulkChange();
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Adds every course of other that is not already present
+    void Union(const BinarySearchTree& other) {
+        if (&other == this) return;
+        TRACE_SCOPE(span, "Union", "bulk");
+        other.materializeAll();
+        root = unionRec(root, copySubtree(other.root), forkDepth());
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Keeps only the courses whose IDs also appear in other
+    void Intersect(const BinarySearchTree& other) {
+        if (&other == this) return;
+        TRACE_SCOPE(span, "Intersect", "bulk");
+        materializeAll(); // pending rows of removed courses must not outlive them
+        root = intersectRec(root, copySubtree(other.root), forkDepth());
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Removes every course whose ID appears in other
+    void Difference(const BinarySearchTree& other) {
+        if (&other == this) {
+            deleteSubtree(root);
+            root = nullptr;
+            size = 0;
+            dropPending();
+            if (hotCache.Enabled()) hotCache.Clear();
+            return;
+        }
+        TRACE_SCOPE(span, "Difference", "bulk");
+        materializeAll(); // pending rows of removed courses must not outlive them
+        root = differenceRec(root, copySubtree(other.root), forkDepth());
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Bulk insert: builds a balanced tree from the batch and unions it in.
+    // Existing courses win over batch entries with the same ID, as with Insert.
+    void InsertBatch(vector<Course> courses) {
+        TRACE_SCOPE(span, "InsertBatch", "bulk");
+        TRACE_ARG(span, "courses", courses.size());
+        sortUnique(courses);
+        root = unionRec(root, buildRec(courses, 0, courses.size()), forkDepth());
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Bulk delete of every listed course ID
+    void DeleteBatch(const vector<string>& courseNumbers) {
+        TRACE_SCOPE(span, "DeleteBatch", "bulk");
+        TRACE_ARG(span, "courses", courseNumbers.size());
+        vector<Course> keys;
+        keys.reserve(courseNumbers.size());
+        for (const string& id : courseNumbers) {
+            keys.push_back(Course{ id, "", {} });
+            forgetPending(id); // the rest of a lazy load stays unparsed
+        }
+        sortUnique(keys);
+        root = differenceRec(root, buildRec(keys, 0, keys.size()), forkDepth());
+        size = nodeCount(root);
+        afterBulkChange();
+    }
+
+    // Returns the stored course for an exact ID, or nullptr; no copy or case folding
+    const Course* Find(const string& courseNumber) const {
+        if (filterRejects(courseNumber)) return nullptr;
+        const Node* node = root;
+        while (node) {
+            if (courseNumber == node->course.courseNumber) {
+                materialize(node->course);
+                return &node->course;
+            }
+            node = courseNumber < node->course.courseNumber ? node->left : node->right;
+        }
+        return nullptr;
+    }
+
+    // The course for an ID in any case, formatted as by formatCourse, or nullptr.
+    // Safe to call from several threads at once, like Find; popular IDs are
+    // answered from the hot cache without touching the tree.
+    shared_ptr<const string> RenderCourse(string_view courseId) const {
+        uint64_t stamp = 0;
+        if (hotCache.Enabled()) {
+            if (auto text = hotCache.Get(courseId, stamp)) return text->empty() ? nullptr : text;
+        }
+        string key(courseId);
+        transform(key.begin(), key.end(), key.begin(), ::toupper);
+        const Course* c = Find(key);
+        auto text = make_shared<const string>(c ? formatCourse(*c) : string()); // empty marks a missing ID
+        if (hotCache.Enabled()) hotCache.Put(courseId, text, stamp);
+        return c ? text : nullptr;
+    }
+
+    static constexpr size_t BATCH_GROUP = 16; // Lookups kept in flight together by SearchBatch
+
+    // Batched exact-ID lookup. Each group of lookups descends one level per round
+    // in lockstep, prefetching every lookup's next node before any of them is
+    // compared again, so the group's cache misses overlap instead of stalling
+    // one after another. results[i] receives the course for keys[i] or nullptr.
+    void SearchBatch(span<const string_view> keys, span<const Course*> results) const {
+        size_t count = min(keys.size(), results.size());
+        for (size_t base = 0; base < count; base += BATCH_GROUP) {
+            size_t group = min(BATCH_GROUP, count - base);
+            const Node* cursor[BATCH_GROUP];
+            bool active = false;
+            for (size_t i = 0; i < group; ++i) {
+                cursor[i] = filterRejects(keys[base + i]) ? nullptr : root;
+                results[base + i] = nullptr;
+                active = active || cursor[i];
+            }
+            while (active) {
+                active = false;
+                for (size_t i = 0; i < group; ++i) {
+                    const Node* node = cursor[i];
+                    if (!node) continue;
+                    int cmp = keys[base + i].compare(node->course.courseNumber);
+                    if (cmp == 0) {
+                        materialize(node->course);
+                        results[base + i] = &node->course;
+                        cursor[i] = nullptr;
+                        continue;
+                    }
+                    node = cmp < 0 ? node->left : node->right;
+                    cursor[i] = node;
+                    if (node) {
+                        prefetchRead(node);
+                        active = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Search for a course by ID
+    Course Search(string courseId) {
+        transform(courseId.begin(), courseId.end(), courseId.begin(), ::toupper);
+        if (filterRejects(courseId)) return Course();
+        return searchRec(root, courseId);
+    }
+
+    int Size() const { return size; }
+
+    int Height() const { return root ? root->height : 0; }
+};
+
+// Persistent (path-copying) AVL tree used for versioned catalog snapshots.
+// Insert/Delete never modify an existing node: they copy the O(log n) nodes on
+// the search path and return a new version that shares every other node with
+// the old one. Nodes are reference counted, so a node is freed as soon as no
+// retained version can reach it.
+class PersistentCatalog {
+private:
+    struct Node;
+    using NodePtr = shared_ptr<const Node>;
+
+    // Immutable tree node; height is fixed at construction
+    struct Node {
+        Course course;
+        NodePtr left;
+        NodePtr right;
+        int height;
+
+        Node(const Course& c, NodePtr l, NodePtr r)
+            : course(c), left(move(l)), right(move(r)),
+              height(1 + max(left ? left->height : 0, right ? right->height : 0)) {}
+    };
+
+    NodePtr root; // Root of this version
+    int size;     // Number of courses in this version
+
+    PersistentCatalog(NodePtr r, int s) : root(move(r)), size(s) {}
+
+    static int nodeHeight(const NodePtr& n) { return n ? n->height : 0; }
+
+    static NodePtr makeNode(const Course& c, NodePtr l, NodePtr r) {
+        return make_shared<const Node>(c, move(l), move(r));
+    }
+
+    // Builds a new node from (course, left, right), rotating if the result
+    // would be out of AVL balance. Rotations allocate fresh nodes rather than
+    // relinking, since the children may be shared with older versions.
+    static NodePtr balance(const Course& c, NodePtr l, NodePtr r) {
+        int bf = nodeHeight(l) - nodeHeight(r);
+        if (bf > 1) {
+            if (nodeHeight(l->left) >= nodeHeight(l->right)) // single right rotation
+                return makeNode(l->course, l->left, makeNode(c, l->right, move(r)));
+            const NodePtr& lr = l->right;                    // left-right rotation
+            return makeNode(lr->course, makeNode(l->course, l->left, lr->left), makeNode(c, lr->right, move(r)));
+        }
+        if (bf < -1) {
+            if (nodeHeight(r->right) >= nodeHeight(r->left)) // single left rotation
+                return makeNode(r->course, makeNode(c, move(l), r->left), r->right);
+            const NodePtr& rl = r->left;                     // right-left rotation
+            return makeNode(rl->course, makeNode(c, move(l), rl->left), makeNode(r->course, rl->right, r->right));
+        }
+        return makeNode(c, move(l), move(r));
+    }
+
+    // Path-copying insert; returns the original node untouched on duplicates
+    static NodePtr insertRec(const NodePtr& node, const Course& c, bool& inserted) {
+        if (!node) {
+            inserted = true;
+            return makeNode(c, nullptr, nullptr);
+        }
+        if (c.courseNumber < node->course.courseNumber) {
+            NodePtr l = insertRec(node->left, c, inserted);
+            return inserted ? balance(node->course, move(l), node->right) : node;
+        }
+        if (c.courseNumber > node->course.courseNumber) {
+            NodePtr r = insertRec(node->right, c, inserted);
+            return inserted ? balance(node->course, node->left, move(r)) : node;
+        }
+        inserted = false; // No duplicates allowed
+        return node;
+    }
+
+    // Removes the smallest course of a subtree, handing it back through minCourse
+    static NodePtr removeMin(const NodePtr& node, Course& minCourse) {
+        if (!node->left) {
+            minCourse = node->course;
+            return node->right;
+        }
+        return balance(node->course, removeMin(node->left, minCourse), node->right);
+    }
+
+    // Path-copying delete; returns the original node untouched when not found
+    static NodePtr deleteRec(const NodePtr& node, const string& courseNumber, bool& deleted) {
+        if (!node) return node;
+        if (courseNumber < node->course.courseNumber) {
+            NodePtr l = deleteRec(node->left, courseNumber, deleted);
+            return deleted ? balance(node->course, move(l), node->right) : node;
+        }
+        if (courseNumber > node->course.courseNumber) {
+            NodePtr r = deleteRec(node->right, courseNumber, deleted);
+            return deleted ? balance(node->course, node->left, move(r)) : node;
+        }
+        deleted = true;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+        Course successor;
+        NodePtr r = removeMin(node->right, successor);
+        return balance(successor, node->left, move(r));
+    }
+
+    // Builds a perfectly balanced subtree from sorted courses [lo, hi)
+    static NodePtr buildRec(const vector<Course>& sorted, size_t lo, size_t hi) {
+        if (lo >= hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        return makeNode(sorted[mid], buildRec(sorted, lo, mid), buildRec(sorted, mid + 1, hi));
+    }
+
+    static void inOrderRec(const NodePtr& node) {
+        if (!node) return;
+        inOrderRec(node->left);
+        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
+        inOrderRec(node->right);
+    }
+
+public:
+    PersistentCatalog() : root(nullptr), size(0) {}
+
+    // Builds a version from courses already sorted by courseNumber in O(n)
+    static PersistentCatalog FromSorted(const vector<Course>& sorted) {
+        return PersistentCatalog(buildRec(sorted, 0, sorted.size()), static_cast<int>(sorted.size()));
+    }
+
+    // Returns a new version containing aCourse; this version is unchanged
+    PersistentCatalog Insert(const Course& aCourse) const {
+        bool inserted = false;
+        NodePtr newRoot = insertRec(root, aCourse, inserted);
+        return PersistentCatalog(move(newRoot), inserted ? size + 1 : size);
+    }
+
+    // Returns a new version without courseNumber; this version is unchanged
+    PersistentCatalog Delete(const string& courseNumber) const {
+        bool deleted = false;
+        NodePtr newRoot = deleteRec(root, courseNumber, deleted);
+        return PersistentCatalog(move(newRoot), deleted ? size - 1 : size);
+    }
+
+    // Search this version for a course by ID
+    Course Search(string courseId) const {
+        transform(courseId.begin(), courseId.end(), courseId.begin(), ::toupper);
+        const Node* node = root.get();
+        while (node) {
+            if (courseId == node->course.courseNumber) return node->course;
+            node = courseId < node->course.courseNumber ? node->left.get() : node->right.get();
+        }
+        return {};
+    }
+
+    void InOrder() const { inOrderRec(root); }
+
+    int Size() const { return size; }
+};
+
+// Convert string to uppercase
+inline void convertCase(string& toConvert) {
+    transform(toConvert.begin(), toConvert.end(), toConvert.begin(),
+        [](unsigned char c) { return toupper(c); });
+}
+
+// Load courses from CSV file into any ordered index (see OrderedIndex.h)
+template <typename Index>
+void loadCourses(const string& filePath, Index* courseList) {
+    TRACE_SCOPE(span, "loadCourses", "load");
+    ifstream inFS(filePath, ios::binary);
+    if (!inFS.is_open()) {
+        cout << "Could not open file (" << filePath << ")." << endl;
+        return;
+    }
+    CsvReader reader(inFS);
+    vector<string_view> fields;
+    size_t rows = 0;
+    for (;;) {
+        {
+            TRACE_SAMPLED_SCOPE(read, "readRow", "load"); // file I/O and field splitting
+            if (!reader.NextRow(fields)) break;
+        }
+        if (fields.size() < 2) continue;
+        Course aCourse{ string(fields[0]), string(fields[1]), {} };
+        for (size_t i = 2; i < fields.size(); ++i) {
+            if (!fields[i].empty()) aCourse.preReqs.emplace_back(fields[i]);
+        }
+        courseList->Insert(aCourse);
+        ++rows;
+    }
+    TRACE_ARG(span, "rows", rows);
+    inFS.close();
+}
+
+// Formats a course as one CSV row in the loader's format (no line terminator)
+inline void appendCsvRow(string& out, const Course& c) {
+    out += c.courseNumber;
+    out += ',';
+    out += c.courseName;
+    for (const string& pre : c.preReqs) {
+        out += ',';
+        out += pre;
+    }
+}
+
+// Display a course and its prerequisites
+inline void displayCourse(const Course& aCourse) {
+    cout << formatCourse(aCourse) << flush;
+}
@@ -1,345 +1,612 @@
 //============================================================================
 // Name        : CourseCatalogAVL.cpp
 // Author      : Sonny Coutu
-// Description : AVL Tree Course Catalog with debug and traversal modes.
+// Description : AVL Tree Course Catalog with tracing and traversal modes.
 //               Implements efficient insert/search/delete operations for a
 //               balanced binary search tree of courses loaded from CSV.
 //               AVL was chosen because of standard BST's efficiency loss  
 //               when using a pre-insertion, sorted list.
 //============================================================================
 
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <vector>
-#include <sstream>
-#include <cctype>
-#include <algorithm>
-#include <limits>
+#define CATALOG_TRACING // load and tree spans on request (PerfTrace.h)
+
+#include "CourseCatalog.h"
+#include "CatalogServer.h"
+#include "CatalogJournal.h"
+#include "CatalogExport.h"
+#include "CourseNameIndex.h"
+#include "EligibilityEngine.h"
+#include "DegreePlanner.h"
+#include "DiskCatalog.h"
+#include "EmbeddedCourses.h"
+#include "MemoryReport.h"
+#include "OrderedIndex.h"
+#include "ShardedCatalog.h"
+#include "WorkloadTrace.h"
 
 #define NOMINMAX
 #ifdef _WIN32
 #include <Windows.h>
 #endif
 
-using namespace std; // using namespace as this is a small project without external non-standard library
+volatile sig_atomic_t stopServer = 0;   // Set by SIGINT/SIGTERM in server mode
+volatile sig_atomic_t reloadServer = 0; // Set by SIGHUP in server mode
 
-bool DEBUG_MODE = true; // Debug mode toggle to show AVL balancing steps
-
-
-// Data structure representing a course and its prerequisites
-struct Course {
-    string courseNumber;       // e.g., "CSCI101"
-    string courseName;         // e.g., "Introduction to Programming in C++"
-    vector<string> preReqs;    // List of prerequisite course IDs
-};
-
-class BinarySearchTree {
-private:
-    // Tree node structure containing a course
-    struct Node {
-        Course course;
-        Node* left;     // Left subtree pointer
-        Node* right;    // Right subtree pointer
-        int height;     // Height of this subtree (used for balancing)
-
-        Node(const Course& c) : course(c), left(nullptr), right(nullptr), height(1) {}
-    };
-
-    Node* root; // Root node of the AVL tree
-    int size;   // Number of courses in the tree
-
-    // Helper: Returns node height (0 if null)
-    int nodeHeight(Node* n) { return n ? n->height : 0; }
-
-    // Updates height after insert/delete/rotation
-    void updateHeight(Node* n) {
-        if (n) n->height = 1 + max(nodeHeight(n->left), nodeHeight(n->right));
-    }
-
-    // Calculates balance factor for AVL balancing
-    int balanceFactor(Node* n) { return n ? nodeHeight(n->left) - nodeHeight(n->right) : 0; }
-
-    // Performs right rotation to maintain AVL balance
-    Node* rotateRight(Node* y) {
-        if (DEBUG_MODE) cout << "[DEBUG] Rotate Right at " << y->course.courseNumber << endl;
-        Node* x = y->left;
-        Node* T2 = x->right;
-        x->right = y;
-        y->left = T2;
-        updateHeight(y);
-        updateHeight(x);
-        return x;
-    }
-
-    // Performs left rotation to maintain AVL balance
-    Node* rotateLeft(Node* x) {
-        if (DEBUG_MODE) cout << "[DEBUG] Rotate Left at " << x->course.courseNumber << endl;
-        Node* y = x->right;
-        Node* T2 = y->left;
-        y->left = x;
-        x->right = T2;
-        updateHeight(x);
-        updateHeight(y);
-        return y;
-    }
-
-    // Recursive insert function maintaining AVL balance
-    Node* insertRec(Node* node, const Course& c, bool& inserted) {
-        if (!node) {
-            if (DEBUG_MODE) cout << "[DEBUG] Insert: " << c.courseNumber << endl;
-            inserted = true;
-            return new Node(c);
-        }
+// Summary line for an incremental reload
+void printReloadSummary(const BinarySearchTree::CatalogDiff& diff) {
+    cout << "Reloaded " << diff.filePath << ": " << diff.inserted.size() << " added, "
+         << diff.deleted.size() << " removed, " << diff.updated.size() << " changed, "
+         << diff.unchanged + diff.relocated.size() << " unchanged." << endl;
+}
 
-        // Traverse to left or right subtree based on course number
-        if (c.courseNumber < node->course.courseNumber) {
-            if (DEBUG_MODE) cout << "[DEBUG] Going left from " << node->course.courseNumber << endl;
-            node->left = insertRec(node->left, c, inserted);
+// Loads the catalog and answers socket clients until interrupted. SIGHUP
+// reloads the file: the diff is computed on a worker thread while requests are
+// still answered, then applied between batches on the server thread.
+int runServer(const string& filePath, const string& socketPath) {
+#ifdef __linux__
+    BinarySearchTree courseList;
+    courseList.EnableMissFilter(true); // clients often ask for IDs that don't exist
+    courseList.EnableHotCache(4096);    // and a few popular IDs make up most lookups
+    loadCourses(filePath, &courseList);
+    CatalogServer server(courseList, socketPath);
+    if (!server.Start()) return 1;
+
+    signal(SIGINT, [](int) { stopServer = 1; });
+    signal(SIGTERM, [](int) { stopServer = 1; });
+    signal(SIGHUP, [](int) { reloadServer = 1; });
+    cout << courseList.Size() << " courses loaded. Serving on " << socketPath
+         << " (Ctrl+C to stop, SIGHUP to reload)" << endl;
+
+    future<BinarySearchTree::CatalogDiff> pendingDiff;
+    server.Run(stopServer, [&] {
+        if (reloadServer && !pendingDiff.valid()) {
+            reloadServer = 0;
+            pendingDiff = async(launch::async, [&courseList, filePath] { return courseList.DiffAgainst(filePath); });
         }
-        else if (c.courseNumber > node->course.courseNumber) {
-            if (DEBUG_MODE) cout << "[DEBUG] Going right from " << node->course.courseNumber << endl;
-            node->right = insertRec(node->right, c, inserted);
-        }
-        else {
-            if (DEBUG_MODE) cout << "[DEBUG] Duplicate course: " << c.courseNumber << endl;
-            inserted = false;
-            return node; // No duplicates allowed
+        if (pendingDiff.valid() && pendingDiff.wait_for(chrono::seconds(0)) == future_status::ready) {
+            BinarySearchTree::CatalogDiff diff = pendingDiff.get();
+            courseList.ApplyDiff(diff);
+            if (diff.ok) printReloadSummary(diff);
         }
+    });
+    if (pendingDiff.valid()) pendingDiff.wait();
+    cout << "Server stopped." << endl;
+    return 0;
+#else
+    cout << "Server mode requires Linux (epoll); cannot serve " << filePath << " on " << socketPath << "." << endl;
+    return 1;
+#endif
+}
 
-        // Update height and check for AVL balance
-        updateHeight(node);
-        int bf = balanceFactor(node);
-        if (DEBUG_MODE) cout << "[DEBUG] Balance factor at " << node->course.courseNumber << " is " << bf << endl;
-
-        // Perform necessary rotations (acceptable balance factor threshold is 0 or |1| )
-        if (bf > 1 && c.courseNumber < node->left->course.courseNumber) return rotateRight(node);
-        if (bf < -1 && c.courseNumber > node->right->course.courseNumber) return rotateLeft(node);
-        if (bf > 1 && c.courseNumber > node->left->course.courseNumber) {
-            node->left = rotateLeft(node->left);
-            return rotateRight(node);
-        }
-        if (bf < -1 && c.courseNumber < node->right->course.courseNumber) {
-            node->right = rotateRight(node->right);
-            return rotateLeft(node);
-        }
+// Loads filePath into any ordered index (OrderedIndex.h) and looks up each ID
+template <typename Index>
+int lookupWith(const string& filePath, const vector<string>& idStrings) {
+    static_assert(OrderedIndex<Index>, "backend does not provide the ordered-index operations");
+    Index courseList;
+    loadCourses(filePath, &courseList);
+    for (const string& id : idStrings) {
+        if (const Course* c = courseList.Find(id)) displayCourse(*c);
+        else cout << id << ": Course not found." << endl;
+    }
+    return 0;
+}
 
-        return node;
+// Looks up every course ID listed in idFile (one per line) in the chosen
+// backend; the default AVL tree answers with SearchBatch
+int runBatchLookup(const string& filePath, const string& idFile, const string& backend) {
+    ifstream ids(idFile);
+    if (!ids.is_open()) {
+        cout << "Could not open file (" << idFile << ")." << endl;
+        return 1;
+    }
+    vector<string> idStrings;
+    string line;
+    while (ids >> line) {
+        convertCase(line);
+        idStrings.push_back(line);
     }
 
-    // Find node with smallest value in subtree
-    Node* minValueNode(Node* node) {
-        Node* current = node;
-        while (current && current->left) current = current->left;
-        return current;
+    if (backend == "avl") {
+        BinarySearchTree courseList;
+        courseList.EnableMissFilter(true);
+        loadCourses(filePath, &courseList);
+        vector<string_view> keys(idStrings.begin(), idStrings.end());
+        vector<const Course*> results(keys.size());
+        courseList.SearchBatch(keys, results);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (results[i]) displayCourse(*results[i]);
+            else cout << idStrings[i] << ": Course not found." << endl;
+        }
+        return 0;
     }
+    if (backend == "sharded") return lookupWith<ShardedCatalog>(filePath, idStrings);
+    if (backend == "red-black") return lookupWith<RedBlackIndex>(filePath, idStrings);
+    if (backend == "b+tree") return lookupWith<BPlusTreeIndex>(filePath, idStrings);
+    if (backend == "skiplist") return lookupWith<SkipListIndex>(filePath, idStrings);
+    if (backend == "map") return lookupWith<StdMapIndex>(filePath, idStrings);
+    cout << "Unknown backend (" << backend << "); use avl, sharded, red-black, b+tree, skiplist or map." << endl;
+    return 1;
+}
 
-    // Recursive delete function maintaining AVL balance
-    Node* deleteRec(Node* root, const string& courseNumber, bool& deleted) {
-        if (!root) return root;
+// Splits a list of course IDs separated by spaces or commas, uppercased
+vector<string> parseCourseList(const string& line) {
+    string spaced = line;
+    replace(spaced.begin(), spaced.end(), ',', ' ');
+    istringstream words(spaced);
+    vector<string> ids;
+    string id;
+    while (words >> id) {
+        convertCase(id);
+        ids.push_back(id);
+    }
+    return ids;
+}
 
-        if (courseNumber < root->course.courseNumber) {
-            if (DEBUG_MODE) cout << "[DEBUG] Going left to delete " << courseNumber << endl;
-            root->left = deleteRec(root->left, courseNumber, deleted);
-        }
-        else if (courseNumber > root->course.courseNumber) {
-            if (DEBUG_MODE) cout << "[DEBUG] Going right to delete " << courseNumber << endl;
-            root->right = deleteRec(root->right, courseNumber, deleted);
-        }
-        else {
-            if (DEBUG_MODE) cout << "[DEBUG] Deleting " << courseNumber << endl;
-            deleted = true;
-
-            // Node with one or no child
-            if (!root->left || !root->right) {
-                Node* temp = root->left ? root->left : root->right;
-                if (!temp) {
-                    temp = root;
-                    root = nullptr;
-                }
-                else *root = *temp;
-                delete temp;
-            }
-            else {
-                // Node with two children: get inorder successor
-                Node* temp = minValueNode(root->right);
-                root->course = temp->course;
-                root->right = deleteRec(root->right, temp->course.courseNumber, deleted);
-            }
-        }
+// For each line of completedFile (one student's completed course IDs), prints
+// the courses that student can take next
+int runEligibility(const string& filePath, const string& completedFile) {
+    BinarySearchTree courseList;
+    loadCourses(filePath, &courseList);
 
-        if (!root) return root; 
-
-        // Update height and rebalance
-        updateHeight(root);
-        int bf = balanceFactor(root); 
-        if (DEBUG_MODE) cout << "[DEBUG] Balance factor after deletion at " << root->course.courseNumber << " is " << bf << endl;
-        
-        // acceptable threshold 0 or |1| again
-        if (bf > 1 && balanceFactor(root->left) >= 0) return rotateRight(root);
-        if (bf > 1 && balanceFactor(root->left) < 0) {
-            root->left = rotateLeft(root->left);
-            return rotateRight(root);
-        }
-        if (bf < -1 && balanceFactor(root->right) <= 0) return rotateLeft(root);
-        if (bf < -1 && balanceFactor(root->right) > 0) {
-            root->right = rotateRight(root->right);
-            return rotateLeft(root);
+    ifstream students(completedFile);
+    if (!students.is_open()) {
+        cout << "Could not open file (" << completedFile << ")." << endl;
+        return 1;
+    }
+    vector<vector<string>> completedSets;
+    string line;
+    while (getline(students, line)) completedSets.push_back(parseCourseList(line));
+
+    EligibilityEngine engine;
+    engine.Build(courseList);
+    vector<vector<uint32_t>> eligible = engine.EligibleBatch(completedSets);
+    string out;
+    for (const vector<uint32_t>& courses : eligible) {
+        for (size_t i = 0; i < courses.size(); ++i) {
+            if (i) out += ',';
+            out += engine.CourseNumber(courses[i]);
         }
-
-        return root;
+        out += '\n';
     }
+    cout << out;
+    return 0;
+}
 
-    // Recursive search for a course by ID
-    Course searchRec(Node* node, const string& courseId) {
-        if (!node) return {};
-        if (node->course.courseNumber == courseId) return node->course;
-        if (courseId < node->course.courseNumber) return searchRec(node->left, courseId);
-        return searchRec(node->right, courseId);
+// Prints a term-by-term plan
+void printPlan(const TermPlan& plan) {
+    for (size_t t = 0; t < plan.terms.size(); ++t) {
+        cout << "Term " << t + 1 << ": ";
+        for (size_t i = 0; i < plan.terms[t].size(); ++i) cout << (i ? ", " : "") << plan.terms[t][i];
+        cout << endl;
     }
+    if (plan.terms.empty() && plan.problems.empty()) cout << "Nothing left to take." << endl;
+    for (const string& problem : plan.problems) cout << "Cannot plan: " << problem << endl;
+}
 
-    // Tree traversal functions
-    void inOrderRec(Node* node) {
-        if (!node) return;
-        inOrderRec(node->left);
-        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
-        inOrderRec(node->right);
-    }
+// Plans every line of cohortFile ("targets ; completed", IDs separated by
+// spaces or commas) and prints one line per student: terms separated by " | "
+int runCohortPlan(const string& filePath, const string& cohortFile, size_t cap) {
+    BinarySearchTree courseList;
+    loadCourses(filePath, &courseList);
 
-    void preOrderRec(Node* node) {
-        if (!node) return;
-        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
-        preOrderRec(node->left);
-        preOrderRec(node->right);
+    ifstream cohort(cohortFile);
+    if (!cohort.is_open()) {
+        cout << "Could not open file (" << cohortFile << ")." << endl;
+        return 1;
+    }
+    vector<PlanRequest> requests;
+    string line;
+    while (getline(cohort, line)) {
+        size_t split = line.find(';');
+        requests.push_back(PlanRequest{ parseCourseList(line.substr(0, split)),
+            split == string::npos ? vector<string>() : parseCourseList(line.substr(split + 1)) });
     }
 
-    void postOrderRec(Node* node) {
-        if (!node) return;
-        postOrderRec(node->left);
-        postOrderRec(node->right);
-        cout << node->course.courseNumber << ", " << node->course.courseName << endl;
+    DegreePlanner planner;
+    planner.Build(courseList);
+    string out;
+    for (const TermPlan& plan : planner.PlanBatch(requests, cap)) {
+        for (size_t t = 0; t < plan.terms.size(); ++t) {
+            if (t) out += " | ";
+            for (size_t i = 0; i < plan.terms[t].size(); ++i) {
+                if (i) out += ',';
+                out += plan.terms[t][i];
+            }
+        }
+        if (!plan.problems.empty()) out += plan.terms.empty() ? "! " : " ! ";
+        for (size_t i = 0; i < plan.problems.size(); ++i) out += (i ? "; " : "") + plan.problems[i];
+        out += '\n';
     }
+    cout << out;
+    return 0;
+}
 
-    // Deletes all nodes in the subtree (used in destructor)
-    void deleteSubtree(Node* node) {
-        if (!node) return;
-        deleteSubtree(node->left);
-        deleteSubtree(node->right);
-        delete node;
+// Full-catalog analytics, each a parallel pass over the tree
+void printCatalogStats(const BinarySearchTree& catalog) {
+    // Courses per department (the letters before the course number)
+    using DepartmentCounts = map<string, int>;
+    DepartmentCounts departments = catalog.ParallelReduce(DepartmentCounts(),
+        [](const Course& c) { return DepartmentCounts{ { string(departmentOf(c.courseNumber)), 1 } }; },
+        [](DepartmentCounts a, const DepartmentCounts& b) {
+            for (const auto& entry : b) a[entry.first] += entry.second;
+            return a;
+        });
+
+    // Prerequisite references that do not resolve to a course
+    vector<const Course*> broken = catalog.ParallelFilter([&catalog](const Course& c) {
+        return any_of(c.preReqs.begin(), c.preReqs.end(), [&catalog](const string& pre) { return !catalog.Find(pre); });
+    });
+
+    // Name lengths and prerequisite counts
+    struct Totals {
+        size_t courses = 0, nameChars = 0, longestName = 0, prereqs = 0, mostPrereqs = 0;
+    };
+    Totals totals = catalog.ParallelReduce(Totals(),
+        [](const Course& c) { return Totals{ 1, c.courseName.size(), c.courseName.size(), c.preReqs.size(), c.preReqs.size() }; },
+        [](Totals a, const Totals& b) {
+            return Totals{ a.courses + b.courses, a.nameChars + b.nameChars, max(a.longestName, b.longestName),
+                           a.prereqs + b.prereqs, max(a.mostPrereqs, b.mostPrereqs) };
+        });
+
+    cout << totals.courses << " courses in " << departments.size() << " departments" << endl;
+    for (const auto& entry : departments) cout << "  " << entry.first << ": " << entry.second << endl;
+    if (totals.courses > 0) {
+        cout << "Average name length " << totals.nameChars / totals.courses << " (longest " << totals.longestName << ")" << endl;
+        cout << "Average prerequisites " << static_cast<double>(totals.prereqs) / totals.courses
+             << " (most " << totals.mostPrereqs << ")" << endl;
     }
+    cout << broken.size() << " courses list a prerequisite that is not in the catalog" << endl;
+    for (const Course* c : broken) {
+        cout << "  " << c->courseNumber << ":";
+        for (const string& pre : c->preReqs) {
+            if (!catalog.Find(pre)) cout << " " << pre;
+        }
+        cout << endl;
+    }
+}
 
-public:
-    BinarySearchTree() : root(nullptr), size(0) {}
-    ~BinarySearchTree() { deleteSubtree(root); }
+void printMemoryLine(const string& label, size_t bytes, const string& detail) {
+    cout << "  " << left << setw(20) << label << right << setw(12) << bytes << " bytes  " << detail << endl;
+}
 
-    // Public traversal wrappers
-    void InOrder() { inOrderRec(root); }
-    void PreOrder() { preOrderRec(root); }
-    void PostOrder() { postOrderRec(root); }
+void printStringLine(const string& label, const StringTally& tally) {
+    printMemoryLine(label, tally.heap.reserved, to_string(tally.strings) + " strings, " + to_string(tally.inlineCount)
+        + " inline, " + to_string(tally.heap.blocks) + " on heap (" + to_string(tally.heap.Slack()) + " slack)");
+}
 
-    // Insert a course into the AVL tree
-    void Insert(const Course& aCourse) {
-        bool inserted = false;
-        root = insertRec(root, aCourse, inserted);
-        if (inserted) ++size;
-    }
+// Heap footprint of the catalog tree, broken down by what holds the bytes
+void printMemoryReport(const BinarySearchTree& catalog) {
+    MemoryUsage usage = measureCatalog(catalog);
+    cout << "Catalog memory: " << usage.Total() << " bytes for " << usage.courses << " courses";
+    if (usage.pending) cout << " (" << usage.pending << " not yet parsed)";
+    cout << endl;
+    printMemoryLine("Tree nodes", usage.nodes.reserved, to_string(usage.courses) + " x " + to_string(sizeof(Course))
+        + " course + " + to_string(usage.courses ? usage.nodes.requested / usage.courses - sizeof(Course) : 0)
+        + " links/balance (" + to_string(usage.nodes.Slack()) + " slack)");
+    printStringLine("Course numbers", usage.courseNumbers);
+    printStringLine("Course names", usage.courseNames);
+    printMemoryLine("Prerequisite arrays", usage.prereqArrays.reserved, to_string(usage.prereqArrays.blocks) + " arrays, "
+        + to_string(usage.prereqSlotsUsed) + " used, " + to_string(usage.prereqSlotsSpare) + " spare capacity ("
+        + to_string(usage.prereqArrays.Slack()) + " slack)");
+    printStringLine("Prerequisite IDs", usage.prereqIds);
+    printMemoryLine("Lazy-load index", usage.pendingIndexBytes, "estimated");
+    printMemoryLine("Missing-ID filter", usage.missFilterBytes, catalog.MissFilterEnabled() ? "on" : "off");
+    size_t requested = usage.nodes.requested + usage.courseNumbers.heap.requested + usage.courseNames.heap.requested
+        + usage.prereqIds.heap.requested + usage.prereqArrays.requested;
+    size_t reserved = usage.nodes.reserved + usage.courseNumbers.heap.reserved + usage.courseNames.heap.reserved
+        + usage.prereqIds.heap.reserved + usage.prereqArrays.reserved;
+    printMemoryLine("Allocator slack", reserved - requested, "reserved beyond what was requested (included above)");
+}
 
-    // Delete a course from the AVL tree
-    bool Delete(const string& courseNumber) {
-        bool deleted = false;
-        root = deleteRec(root, courseNumber, deleted);
-        if (deleted) --size;
-        return deleted;
+void printAllocations(const string& operation, const AllocationScope& scope) {
+    cout << "  " << left << setw(20) << operation << right << setw(8) << scope.Allocations() << " allocations"
+         << setw(12) << scope.Bytes() << " bytes" << setw(8) << scope.Frees() << " frees" << endl;
+}
+
+// Batch mode: footprint report plus what common operations allocate
+int runMemoryReport(const string& filePath) {
+    BinarySearchTree courseList;
+    AllocationScope loading;
+    loadCourses(filePath, &courseList);
+    AllocationScope afterLoad;
+    if (courseList.Size() == 0) return 1;
+    printMemoryReport(courseList);
+    if (!ALLOCATIONS_COUNTED) {
+        cout << "Allocations per operation: build with /DCATALOG_ALLOCATION_HOOK to count them." << endl;
+        return 0;
+    }
+    cout << "Allocations per operation:" << endl;
+    cout << "  " << left << setw(20) << "Load" << right << setw(8) << loading.Allocations() - afterLoad.Allocations()
+         << " allocations" << setw(12) << loading.Bytes() - afterLoad.Bytes() << " bytes" << endl;
+    string present;
+    courseList.ForEach([&present](const Course& c) { if (present.empty()) present = c.courseNumber; });
+    string absent = "ZZZZ9999";
+    Course probe{ absent, "Allocation probe course with a name too long for inline storage", { present } };
+    {
+        AllocationScope scope;
+        courseList.Find(present);
+        printAllocations("Find (hit)", scope);
     }
+    {
+        AllocationScope scope;
+        courseList.Find(absent);
+        printAllocations("Find (miss)", scope);
+    }
+    {
+        AllocationScope scope;
+        courseList.Search(present);
+        printAllocations("Search (copy)", scope);
+    }
+    {
+        AllocationScope scope;
+        courseList.Insert(probe);
+        printAllocations("Insert", scope);
+    }
+    {
+        AllocationScope scope;
+        courseList.Delete(absent);
+        printAllocations("Delete", scope);
+    }
+    return 0;
+}
 
-    // Search for a course by ID
-    Course Search(string courseId) {
-        transform(courseId.begin(), courseId.end(), courseId.begin(), ::toupper);
-        return searchRec(root, courseId);
+// Stops trace capture and writes what was recorded
+void finishPerfTrace(const string& tracePath) {
+    PerfTracer& tracer = PerfTracer::Global();
+    tracer.Stop();
+    if (tracer.WriteJson(tracePath)) {
+        cout << "Wrote " << tracer.EventCount() << " trace events to " << tracePath << " (open in Perfetto)" << endl;
     }
+    else cout << "Could not write trace file (" << tracePath << ")." << endl;
+}
 
-    int Size() { return size; }
-};
+// Batch mode: traces an eager and a lazy load of the same file
+int runTracedLoad(const string& filePath, const string& tracePath, uint32_t sampleEvery) {
+    PerfTracer::Global().Start(sampleEvery);
+    BinarySearchTree eager, lazy;
+    loadCourses(filePath, &eager);
+    lazy.LoadIndex(filePath);
+    finishPerfTrace(tracePath);
+    return eager.Size() > 0 ? 0 : 1;
+}
+
+// Batch mode: checks two catalog files for identical contents using content
+// hashes, then lists what differs. Exit code 0 when identical, like cmp.
+int runCompare(const string& firstPath, const string& secondPath) {
+    BinarySearchTree first, second;
+    first.EnableContentHashes(true);
+    second.EnableContentHashes(true);
+    loadCourses(firstPath, &first);
+    loadCourses(secondPath, &second);
+    auto printSummary = [](const string& path, const BinarySearchTree& catalog) {
+        cout << path << ": " << catalog.Size() << " courses, content hash "
+             << hex << setw(16) << setfill('0') << catalog.RootHash() << dec << setfill(' ') << endl;
+    };
+    printSummary(firstPath, first);
+    printSummary(secondPath, second);
+    if (first.ContentEquals(second)) {
+        cout << "Identical." << endl;
+        return 0;
+    }
+    ContentDiff diff = first.DiffContents(second);
+    for (const string& id : diff.onlyHere) cout << "  - " << id << " (only in " << firstPath << ")" << endl;
+    for (const string& id : diff.onlyThere) cout << "  + " << id << " (only in " << secondPath << ")" << endl;
+    for (const string& id : diff.changed) cout << "  * " << id << " (changed)" << endl;
+    cout << diff.onlyHere.size() + diff.onlyThere.size() + diff.changed.size() << " differences found by comparing "
+         << diff.rangesCompared << " key ranges." << endl;
+    return 1;
+}
 
-// Efficient CSV Split using stringstream
-vector<string> Split(const string& lineFeed) {
-    vector<string> tokens;
-    stringstream ss(lineFeed);
-    string token;
-    while (getline(ss, token, ',')) {
-        token.erase(0, token.find_first_not_of(" \t\r\n"));
-        token.erase(token.find_last_not_of(" \t\r\n") + 1);
-        tokens.push_back(token);
+// Batch mode: loads a catalog CSV into per-department trees (parsed and built
+// in parallel) and lists the shards
+int runShardedLoad(const string& filePath) {
+    ShardedCatalog catalog;
+    auto start = chrono::steady_clock::now();
+    if (!catalog.Load(filePath)) return 1;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    for (const string& department : catalog.Departments()) {
+        const BinarySearchTree* shard = catalog.Shard(department);
+        cout << "  " << left << setw(10) << (department.empty() ? "(none)" : department) << right
+             << setw(10) << shard->Size() << " courses, height " << shard->Height() << endl;
     }
-    return tokens;
+    cout << catalog.Size() << " courses in " << catalog.Departments().size() << " department shards, loaded in "
+         << fixed << setprecision(1) << ms << " ms on " << WorkStealingPool::Shared().Workers() + 1 << " threads." << endl;
+    return catalog.Size() > 0 ? 0 : 1;
 }
 
-// Convert string to uppercase
-void convertCase(string& toConvert) {
-    transform(toConvert.begin(), toConvert.end(), toConvert.begin(),
-        [](unsigned char c) { return toupper(c); });
+// Batch mode: builds a disk catalog (page file) from a catalog CSV
+int runDiskBuild(const string& filePath, const string& pagePath) {
+    DiskCatalog catalog;
+    if (!catalog.Create(pagePath) || !catalog.Load(filePath)) return 1;
+    cout << "Wrote " << catalog.Size() << " courses to " << pagePath << ": " << catalog.PageCount() << " pages of "
+         << DiskCatalog::PAGE_SIZE << " bytes, height " << catalog.Height() << "." << endl;
+    return 0;
 }
 
-// Load courses from CSV file
-void loadCourses(const string& filePath, BinarySearchTree* courseList) {
-    ifstream inFS(filePath);
-    string line;
-    if (!inFS.is_open()) {
-        cout << "Could not open file (" << filePath << ")." << endl;
-        return;
-    }
-    while (getline(inFS, line)) {
-        if (line.empty()) continue;
-        vector<string> tokens = Split(line);
-        if (tokens.size() < 2) continue;
-        Course aCourse{ tokens[0], tokens[1], {} };
-        for (size_t i = 2; i < tokens.size(); ++i) {
-            if (!tokens[i].empty()) aCourse.preReqs.push_back(tokens[i]);
-        }
-        courseList->Insert(aCourse);
+// Batch mode: looks up every course ID in idFile against a disk catalog and
+// reports the page reads they took
+int runDiskLookup(const string& pagePath, const string& idFile, size_t cachePages) {
+    DiskCatalog catalog;
+    if (!catalog.Open(pagePath, cachePages)) return 1;
+    ifstream ids(idFile);
+    if (!ids.is_open()) {
+        cout << "Could not open file (" << idFile << ")." << endl;
+        return 1;
     }
-    inFS.close();
+    size_t lookups = 0;
+    string id;
+    while (ids >> id) {
+        Course c = catalog.Search(id);
+        if (!c.courseNumber.empty()) displayCourse(c);
+        else cout << id << ": Course not found." << endl;
+        ++lookups;
+    }
+    if (!catalog.Flush()) return 1; // a page that could not be read
+    const PageCache::Stats& stats = catalog.CacheStats();
+    cout << lookups << " lookups: " << stats.reads << " page reads, " << stats.hits << " cache hits ("
+         << catalog.CachePages() << "-page cache, at most " << catalog.Height() << " pages per lookup)." << endl;
+    return 0;
 }
 
-// Display a course and its prerequisites
-void displayCourse(const Course& aCourse) {
-    cout << aCourse.courseNumber << ", " << aCourse.courseName << endl;
-    cout << "Prerequisites: ";
-    if (aCourse.preReqs.empty()) cout << "none" << endl;
-    else {
-        for (size_t i = 0; i < aCourse.preReqs.size(); ++i) {
-            cout << aCourse.preReqs[i];
-            if (i + 1 < aCourse.preReqs.size()) cout << ", ";
+// Summary line for a finished export
+void printExportSummary(const ExportResult& result, const string& exportPath) {
+    cout << "Exported " << result.courses << " courses (" << fixed << setprecision(1) << result.bytes / 1048576.0
+         << " MB) to " << exportPath << " in " << setprecision(3) << result.seconds << " s." << endl;
+    cout << defaultfloat << setprecision(6); // the menu keeps using cout
+}
+
+// Batch mode: writes a catalog CSV to exportPath as CSV, JSON Lines or a JSON array (by extension)
+int runExport(const string& filePath, const string& exportPath) {
+    BinarySearchTree courseList;
+    loadCourses(filePath, &courseList);
+    ExportResult result = exportCatalog(courseList, exportPath, exportFormatFor(exportPath));
+    if (!result.ok) return 1;
+    printExportSummary(result, exportPath);
+    return 0;
+}
+
+// Prints a compiled-in course the way displayCourse prints a loaded one
+void displayEmbeddedCourse(const EmbeddedCourse& c) {
+    cout << c.id << ", " << c.name << "\nPrerequisites: ";
+    span<const string_view> prereqs = EMBEDDED_CATALOG.Prerequisites(c);
+    if (prereqs.empty()) cout << "none";
+    for (size_t i = 0; i < prereqs.size(); ++i) cout << (i ? ", " : "") << prereqs[i];
+    cout << endl;
+}
+
+// Kiosk mode: answers from the catalog compiled into the binary
+// (EmbeddedCourses.h) without opening or parsing any file. Lists every course
+// when no IDs are given.
+int runEmbedded(int idCount, char* ids[]) {
+    if (idCount == 0) {
+        for (const EmbeddedCourse& c : EMBEDDED_CATALOG.Courses()) cout << c.id << ", " << c.name << '\n';
+        cout << EMBEDDED_CATALOG.Size() << " courses built in from " << EMBEDDED_SOURCE << "." << endl;
+        return 0;
+    }
+    int missing = 0;
+    for (int i = 0; i < idCount; ++i) {
+        string courseId = ids[i];
+        convertCase(courseId);
+        if (const EmbeddedCourse* c = EMBEDDED_CATALOG.Find(courseId)) displayEmbeddedCourse(*c);
+        else {
+            cout << courseId << ": Course not found." << endl;
+            ++missing;
         }
-        cout << endl;
     }
+    return missing ? 1 : 0;
 }
 
 // ======================== MAIN ========================
 int main(int argc, char* argv[]) {
     string filePath, courseKey;
 
-    // Allow optional command-line file path argument
-    switch (argc) {
-    case 2: filePath = argv[1]; break;
-    case 3: filePath = argv[1]; courseKey = argv[2]; break;
-    default: filePath = "courses.csv"; // bundled file used for testing.
+    // Kiosk mode: CourseCatalogAVL --embedded [courseId ...]
+    if (argc > 1 && string(argv[1]) == "--embedded") return runEmbedded(argc - 2, argv + 2);
+
+    // Server mode: CourseCatalogAVL --serve [courses.csv] [socketPath]
+    if (argc > 1 && string(argv[1]) == "--serve") {
+        return runServer(argc > 2 ? argv[2] : "courses.csv", argc > 3 ? argv[3] : "/tmp/course_catalog.sock");
+    }
+
+    // Batch mode: CourseCatalogAVL --lookup courses.csv ids.txt [avl|sharded|red-black|b+tree|skiplist|map]
+    if ((argc == 4 || argc == 5) && string(argv[1]) == "--lookup") {
+        return runBatchLookup(argv[2], argv[3], argc == 5 ? argv[4] : "avl");
+    }
+
+    // Eligibility mode: CourseCatalogAVL --eligible courses.csv completed.txt
+    if (argc == 4 && string(argv[1]) == "--eligible") return runEligibility(argv[2], argv[3]);
+
+    // Analytics mode: CourseCatalogAVL --stats courses.csv
+    if (argc == 3 && string(argv[1]) == "--stats") {
+        BinarySearchTree courseList;
+        loadCourses(argv[2], &courseList);
+        printCatalogStats(courseList);
+        return 0;
+    }
+
+    // Memory mode: CourseCatalogAVL --memory courses.csv
+    if (argc == 3 && string(argv[1]) == "--memory") return runMemoryReport(argv[2]);
+
+    // Compare mode: CourseCatalogAVL --compare courses.csv other.csv
+    if (argc == 4 && string(argv[1]) == "--compare") return runCompare(argv[2], argv[3]);
+
+    // Export mode: CourseCatalogAVL --export courses.csv out.csv|out.jsonl|out.json
+    if (argc == 4 && string(argv[1]) == "--export") return runExport(argv[2], argv[3]);
+
+    // Sharded mode: CourseCatalogAVL --shards courses.csv
+    if (argc == 3 && string(argv[1]) == "--shards") return runShardedLoad(argv[2]);
+
+    // Disk catalog modes: CourseCatalogAVL --disk-build courses.csv catalog.pages
+    //                     CourseCatalogAVL --disk-lookup catalog.pages ids.txt [cachePages]
+    if (argc == 4 && string(argv[1]) == "--disk-build") return runDiskBuild(argv[2], argv[3]);
+    if ((argc == 4 || argc == 5) && string(argv[1]) == "--disk-lookup") {
+        return runDiskLookup(argv[2], argv[3], argc == 5 ? static_cast<size_t>(max(8, atoi(argv[4]))) : DiskCatalog::DEFAULT_CACHE_PAGES);
+    }
+
+    // Tracing mode: CourseCatalogAVL --trace-load courses.csv trace.json [sampleEvery]
+    if ((argc == 4 || argc == 5) && string(argv[1]) == "--trace-load") {
+        return runTracedLoad(argv[2], argv[3], argc == 5 ? static_cast<uint32_t>(max(1, atoi(argv[4]))) : 64);
+    }
+
+    // Planning mode: CourseCatalogAVL --plan courses.csv cohort.txt [coursesPerTerm]
+    if ((argc == 4 || argc == 5) && string(argv[1]) == "--plan") {
+        return runCohortPlan(argv[2], argv[3], argc == 5 ? max(0, atoi(argv[4])) : 3);
+    }
+
+    // Recording mode: CourseCatalogAVL --record trace.txt [courses.csv]
+    // runs the menu and writes its operations to a trace for CatalogWorkload
+    WorkloadRecorder recorder;
+    if ((argc == 3 || argc == 4) && string(argv[1]) == "--record") {
+        if (!recorder.Open(argv[2])) return 1;
+        filePath = argc == 4 ? argv[3] : "courses.csv";
+    }
+    else {
+        // Allow optional command-line file path argument
+        switch (argc) {
+        case 2: filePath = argv[1]; break;
+        case 3: filePath = argv[1]; courseKey = argv[2]; break;
+        default: filePath = "courses.csv"; // bundled file used for testing.
+        }
     }
 
     BinarySearchTree* courseList = new BinarySearchTree();
+    PersistentCatalog liveVersion;                  // Mirrors courseList so term snapshots are O(1)
+    bool mirrorBuilt = false;                       // liveVersion is built at the first snapshot
+    map<string, PersistentCatalog> termSnapshots;   // Saved versions keyed by term label
     Course course;
     bool readOnce = false; // Sentinel, as to not add courseList repeatedly.
+    bool lazyLoad = false; // Option 12: index IDs at load, parse each course on first use
+    CatalogJournal journal; // Durable log of edits made since filePath was last compacted
+    CourseNameIndex nameIndex;
+    bool nameIndexBuilt = false; // Rebuilt on the next name search after any edit
+    EligibilityEngine eligibility;
+    bool eligibilityBuilt = false;
+    DegreePlanner planner;
+    bool plannerBuilt = false;
+    string tracePath; // Where option 7 writes its trace when stopped
     int choice = 0;
 
     while (choice != 9) {
         cout << "\nMenu:\n";
-        cout << "  1. Load Courses\n";
+        cout << "  1. Load / Reload Courses\n";
         cout << "  2. Display All Courses (InOrder)\n";
         cout << "  3. Find Course\n";
         cout << "  4. Delete Course\n";
         cout << "  5. Display PreOrder\n";
         cout << "  6. Display PostOrder\n";
-        cout << "  7. Toggle Debug Mode\n";
+        cout << "  7. Start / Stop Performance Trace\n";
+        cout << "  8. Save Term Snapshot\n";
+        cout << "  10. Display Term Snapshot\n";
+        cout << "  11. Merge Courses From File\n";
+        cout << "  12. Toggle Lazy Loading\n";
+        cout << "  13. Compact Journal Into Course File\n";
+        cout << "  14. Find Course By Name\n";
+        cout << "  15. Show Courses Available Next\n";
+        cout << "  16. Plan Terms To Target Courses\n";
+        cout << "  17. Toggle Missing-ID Filter\n";
+        cout << "  18. Catalog Statistics\n";
+        cout << "  19. Memory Usage Report\n";
+        cout << "  20. Export Catalog To CSV / JSON\n";
         cout << "  9. Exit\n";
         cout << "Enter choice: ";
 
@@ -348,20 +615,36 @@ int main(int argc, char* argv[]) {
 
         try {
             if (!(cin >> choice)) throw 1;
-            if (!((choice > 0 && choice < 8) || choice == 9)) throw 1;
+            if (choice < 1 || choice > 20) throw 1;
 
             switch (choice) {
             case 1:
+                recorder.Record('L', filePath);
                 if (!readOnce) {
-                    loadCourses(filePath, courseList);
-                    cout << courseList->Size() << " courses loaded." << endl;
+                    if (lazyLoad) courseList->LoadIndex(filePath);
+                    else loadCourses(filePath, courseList);
+                    size_t replayed = journal.Open(filePath + ".wal", *courseList); // edits from earlier sessions
+                    cout << courseList->Size() << " courses loaded";
+                    if (replayed > 0) cout << ", " << replayed << " journaled edits replayed";
+                    if (courseList->PendingCount() > 0) cout << " (details read on first use)";
+                    cout << "." << endl;
                     readOnce = true;
                 }
-                else cout << "Courses already loaded.\n";
+                else { // apply only what changed in the file since it was loaded
+                    BinarySearchTree::CatalogDiff diff = courseList->Reload(filePath);
+                    if (diff.ok) {
+                        journal.Replay(*courseList); // journaled edits stay on top of the file
+                        printReloadSummary(diff);
+                        if (!diff.Empty()) mirrorBuilt = nameIndexBuilt = eligibilityBuilt = plannerBuilt = false;
+                    }
+                }
                 break;
 
             case 2:
-                if (readOnce) courseList->InOrder();
+                if (readOnce) {
+                    recorder.Record('T');
+                    courseList->InOrder();
+                }
                 else cout << "Load courses first.\n";
                 break;
 
@@ -369,8 +652,8 @@ int main(int argc, char* argv[]) {
                 cout << "Enter course identifier: ";
                 cin >> courseKey;
                 convertCase(courseKey);
-                course = courseList->Search(courseKey);
-                if (!course.courseNumber.empty()) displayCourse(course);
+                recorder.Record('F', courseKey);
+                if (auto text = courseList->RenderCourse(courseKey)) cout << *text;
                 else cout << "Course not found.\n";
                 break;
 
@@ -379,25 +662,187 @@ int main(int argc, char* argv[]) {
                     cout << "Enter course to delete: ";
                     cin >> courseKey;
                     convertCase(courseKey);
-                    if (courseList->Delete(courseKey)) cout << "Deleted " << courseKey << endl;
+                    recorder.Record('D', courseKey);
+                    if (courseList->Delete(courseKey)) {
+                        bool logged = journal.WaitDurable(journal.LogDelete(courseKey));
+                        if (mirrorBuilt) liveVersion = liveVersion.Delete(courseKey);
+                        nameIndexBuilt = eligibilityBuilt = plannerBuilt = false;
+                        cout << "Deleted " << courseKey << (logged ? "" : " (not journaled; lost on exit)") << endl;
+                        if (journal.NeedsCompaction()) journal.Compact(*courseList, filePath);
+                    }
                     else cout << "Course not found.\n";
                 }
                 else cout << "Load courses first.\n";
                 break;
 
             case 5:
-                if (readOnce) courseList->PreOrder();
+                if (readOnce) {
+                    recorder.Record('T');
+                    courseList->PreOrder();
+                }
                 else cout << "Load courses first.\n";
                 break;
 
             case 6:
-                if (readOnce) courseList->PostOrder();
+                if (readOnce) {
+                    recorder.Record('T');
+                    courseList->PostOrder();
+                }
                 else cout << "Load courses first.\n";
                 break;
 
             case 7: // Toggle
-                DEBUG_MODE = !DEBUG_MODE;
-                cout << "Debug mode " << (DEBUG_MODE ? "ON" : "OFF") << endl;
+                if (!PerfTracer::Global().Enabled()) {
+                    cout << "Enter trace file: ";
+                    cin >> tracePath;
+                    PerfTracer::Global().Start();
+                    cout << "Tracing ON; choose 7 again to write " << tracePath << endl;
+                }
+                else finishPerfTrace(tracePath);
+                break;
+
+            case 8:
+                if (readOnce) {
+                    cout << "Enter term label: ";
+                    cin >> courseKey;
+                    if (!mirrorBuilt) { // reads every pending course once
+                        vector<Course> sorted;
+                        courseList->ForEach([&sorted](const Course& c) { sorted.push_back(c); });
+                        liveVersion = PersistentCatalog::FromSorted(sorted);
+                        mirrorBuilt = true;
+                    }
+                    termSnapshots[courseKey] = liveVersion; // shares every node with the live version
+                    cout << "Saved snapshot " << courseKey << " (" << liveVersion.Size() << " courses)" << endl;
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 10:
+                cout << "Enter term label: ";
+                cin >> courseKey;
+                if (termSnapshots.count(courseKey)) termSnapshots[courseKey].InOrder();
+                else cout << "No snapshot for " << courseKey << ".\n";
+                break;
+
+            case 11:
+                if (readOnce) {
+                    cout << "Enter file to merge: ";
+                    cin >> courseKey;
+                    recorder.Record('M', courseKey);
+                    BinarySearchTree incoming;
+                    loadCourses(courseKey, &incoming);
+                    int before = courseList->Size();
+                    uint64_t lastRecord = 0;
+                    incoming.ForEach([&](const Course& c) { // one fsync covers the whole merge
+                        if (!courseList->Find(c.courseNumber)) lastRecord = journal.LogInsert(c);
+                    });
+                    courseList->Union(incoming); // existing courses win on duplicate IDs
+                    journal.WaitDurable(lastRecord);
+                    if (journal.NeedsCompaction()) journal.Compact(*courseList, filePath);
+                    mirrorBuilt = nameIndexBuilt = eligibilityBuilt = plannerBuilt = false;
+                    cout << courseList->Size() - before << " new courses merged." << endl;
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 12:
+                lazyLoad = !lazyLoad;
+                cout << "Lazy loading " << (lazyLoad ? "ON" : "OFF") << endl;
+                break;
+
+            case 13:
+                if (readOnce) {
+                    if (journal.Compact(*courseList, filePath)) cout << "Journal folded into " << filePath << "." << endl;
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 14:
+                if (readOnce) {
+                    cout << "Enter part of the course name: ";
+                    cin >> ws;
+                    getline(cin, courseKey);
+                    cin.unget(); // leave the newline for the buffer clear below
+                    if (!nameIndexBuilt) {
+                        nameIndex.Build(*courseList);
+                        nameIndexBuilt = true;
+                    }
+                    vector<NameMatch> matches = nameIndex.Complete(courseKey, 10);
+                    for (const NameMatch& m : nameIndex.Contains(courseKey, 10)) { // mid-word matches after completions
+                        if (matches.size() >= 10) break;
+                        bool listed = any_of(matches.begin(), matches.end(),
+                            [&m](const NameMatch& n) { return n.courseNumber == m.courseNumber; });
+                        if (!listed) matches.push_back(m);
+                    }
+                    for (const NameMatch& m : matches) cout << m.courseNumber << ", " << m.courseName << endl;
+                    if (matches.empty()) cout << "No course names match.\n";
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 15:
+                if (readOnce) {
+                    cout << "Enter completed courses (comma or space separated): ";
+                    cin >> ws;
+                    getline(cin, courseKey);
+                    cin.unget(); // leave the newline for the buffer clear below
+                    if (!eligibilityBuilt) {
+                        eligibility.Build(*courseList);
+                        eligibilityBuilt = true;
+                    }
+                    vector<string> available = eligibility.Eligible(parseCourseList(courseKey));
+                    for (const string& id : available) displayCourse(courseList->Search(id));
+                    if (available.empty()) cout << "No courses available with those prerequisites.\n";
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 16:
+                if (readOnce) {
+                    PlanRequest request;
+                    int cap = 0;
+                    cout << "Enter target courses: ";
+                    cin >> ws;
+                    getline(cin, courseKey);
+                    request.targets = parseCourseList(courseKey);
+                    cout << "Enter completed courses (blank line for none): ";
+                    getline(cin, courseKey);
+                    request.completed = parseCourseList(courseKey);
+                    cout << "Maximum courses per term: ";
+                    if (!(cin >> cap) || cap < 1) throw 1;
+                    if (!plannerBuilt) {
+                        planner.Build(*courseList);
+                        plannerBuilt = true;
+                    }
+                    printPlan(planner.Plan(request, static_cast<size_t>(cap)));
+                }
+                else cout << "Load courses first.\n";
+                break;
+
+            case 17:
+                courseList->EnableMissFilter(!courseList->MissFilterEnabled());
+                cout << "Missing-ID filter " << (courseList->MissFilterEnabled() ? "ON" : "OFF") << endl;
+                break;
+
+            case 18:
+                if (readOnce) printCatalogStats(*courseList);
+                else cout << "Load courses first.\n";
+                break;
+
+            case 19:
+                if (readOnce) printMemoryReport(*courseList);
+                else cout << "Load courses first.\n";
+                break;
+
+            case 20:
+                if (readOnce) {
+                    string exportPath;
+                    cout << "Export to file (.csv, .jsonl or .json): ";
+                    cin >> exportPath;
+                    ExportResult result = exportCatalog(*courseList, exportPath, exportFormatFor(exportPath));
+                    if (result.ok) printExportSummary(result, exportPath);
+                }
+                else cout << "Load courses first.\n";
                 break;
 
             case 9: break;
@@ -417,6 +862,7 @@ int main(int argc, char* argv[]) {
 #endif
     }
 
+    if (PerfTracer::Global().Enabled()) finishPerfTrace(tracePath);
     cout << "Thank you for using the Course Catalog!\n";
     delete courseList;
     return 0;
@@ -0,0 +1,139 @@
+//============================================================================
+// Name        : CourseNameIndex.h
+// Author      : Sonny Coutu
+// Description : Search courses by name instead of ID. A sorted array of every
+//               word-start suffix of the course names answers autocomplete
+//               ("Operating Sys", "Linear"), and a trigram inverted index
+//               answers substring queries ("gebra"). Both are built in one
+//               pass over the catalog and are case-insensitive.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <unordered_map>
+
+// A course found by name; views stay valid until the index is rebuilt
+struct NameMatch {
+    string_view courseNumber;
+    string_view courseName;
+};
+
+class CourseNameIndex {
+private:
+    struct Entry {
+        string courseNumber;
+        string courseName;
+        string folded;      // Lowercase name, what queries are matched against
+    };
+
+    // Suffix of entries[entry].folded starting at a word boundary
+    struct Suffix {
+        uint32_t entry;
+        uint32_t offset;
+    };
+
+    vector<Entry> entries;                              // Courses in key order
+    vector<Suffix> suffixes;                            // Sorted by suffix text
+    unordered_map<uint32_t, vector<uint32_t>> trigrams; // Trigram -> ascending entry indices
+
+    static string fold(string_view text) {
+        string out(text);
+        for (char& c : out) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    static uint32_t trigramAt(const string& text, size_t i) {
+        return (uint32_t(static_cast<unsigned char>(text[i])) << 16)
+             | (uint32_t(static_cast<unsigned char>(text[i + 1])) << 8)
+             | uint32_t(static_cast<unsigned char>(text[i + 2]));
+    }
+
+    string_view suffixText(const Suffix& s) const {
+        return string_view(entries[s.entry].folded).substr(s.offset);
+    }
+
+    NameMatch match(uint32_t entry) const {
+        return NameMatch{ entries[entry].courseNumber, entries[entry].courseName };
+    }
+
+public:
+    // Rebuilds both indexes from the catalog (reads every course's name)
+    void Build(const BinarySearchTree& catalog) {
+        entries.clear();
+        suffixes.clear();
+        trigrams.clear();
+        catalog.ForEach([this](const Course& c) {
+            entries.push_back(Entry{ c.courseNumber, c.courseName, fold(c.courseName) });
+        });
+
+        for (uint32_t e = 0; e < entries.size(); ++e) {
+            const string& name = entries[e].folded;
+            for (size_t i = 0; i < name.size(); ++i) {
+                bool wordStart = isalnum(static_cast<unsigned char>(name[i]))
+                    && (i == 0 || !isalnum(static_cast<unsigned char>(name[i - 1])));
+                if (wordStart) suffixes.push_back(Suffix{ e, static_cast<uint32_t>(i) });
+            }
+            for (size_t i = 0; i + 3 <= name.size(); ++i) {
+                vector<uint32_t>& postings = trigrams[trigramAt(name, i)];
+                if (postings.empty() || postings.back() != e) postings.push_back(e);
+            }
+        }
+        sort(suffixes.begin(), suffixes.end(), [this](const Suffix& a, const Suffix& b) {
+            int order = suffixText(a).compare(suffixText(b));
+            return order != 0 ? order < 0 : a.entry < b.entry;
+        });
+    }
+
+    // Up to limit courses with a name word starting with prefix, in order of
+    // the completed text ("linear" -> "Linear Algebra" before "Linear Systems")
+    vector<NameMatch> Complete(string_view prefix, size_t limit) const {
+        vector<NameMatch> results;
+        string key = fold(prefix);
+        if (key.empty()) return results;
+        auto first = lower_bound(suffixes.begin(), suffixes.end(), key,
+            [this](const Suffix& s, const string& k) { return suffixText(s) < k; });
+        vector<uint32_t> seen; // A name can match at more than one word
+        for (auto it = first; it != suffixes.end() && results.size() < limit; ++it) {
+            string_view text = suffixText(*it);
+            if (text.compare(0, key.size(), key) != 0) break; // past the prefix range
+            if (find(seen.begin(), seen.end(), it->entry) != seen.end()) continue;
+            seen.push_back(it->entry);
+            results.push_back(match(it->entry));
+        }
+        return results;
+    }
+
+    // Up to limit courses whose name contains fragment anywhere, in key order.
+    // Candidates are the intersection of the fragment's trigram posting lists;
+    // fragments shorter than a trigram fall back to word-prefix matching.
+    vector<NameMatch> Contains(string_view fragment, size_t limit) const {
+        string key = fold(fragment);
+        if (key.size() < 3) return Complete(key, limit);
+
+        vector<const vector<uint32_t>*> lists;
+        for (size_t i = 0; i + 3 <= key.size(); ++i) {
+            auto it = trigrams.find(trigramAt(key, i));
+            if (it == trigrams.end()) return {};
+            lists.push_back(&it->second);
+        }
+        sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+        vector<uint32_t> candidates = *lists[0], narrowed;
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+            narrowed.clear();
+            set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                back_inserter(narrowed));
+            candidates.swap(narrowed);
+        }
+
+        vector<NameMatch> results;
+        for (uint32_t e : candidates) {
+            if (results.size() >= limit) break;
+            if (entries[e].folded.find(key) != string::npos) results.push_back(match(e)); // trigrams can match out of order
+        }
+        return results;
+    }
+
+    size_t Size() const { return entries.size(); }
+};
@@ -0,0 +1,62 @@
+//============================================================================
+// Name        : CpuFeatures.h
+// Author      : Sonny Coutu
+// Description : x86 detection and runtime CPU feature checks shared by the
+//               vectorized kernels (CSV scanning, eligibility tests). Code
+//               inside #ifdef CPU_X86 may use the intrinsics; a function
+//               marked CPU_TARGET_AVX2 must only be called after
+//               cpuHasAvx2() returned true.
+//============================================================================
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang compile a function for a wider instruction set only when asked;
+// MSVC accepts the intrinsics anywhere
+#if defined(CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#define CPU_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define CPU_TARGET_AVX2
+#define CPU_TARGET_SSE2
+#endif
+
+#ifdef CPU_X86
+
+// AVX2 needs both CPU support and the OS saving YMM state
+inline bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool cpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true; // part of the x86-64 baseline
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // CPU_X86
@@ -0,0 +1,219 @@
+//============================================================================
+// Name        : CsvScanner.h
+// Author      : Sonny Coutu
+// Description : Vectorized CSV structural scanner. Finds every ',', '\n' and
+//               '\r' 64 bytes per step (AVX2 or SSE2, picked at runtime, with
+//               a scalar fallback) and hands the loader field offsets instead
+//               of copying each line and token through getline/stringstream.
+//============================================================================
+
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Appends the offset of every structural byte (',' '\n' '\r') in data[0, length)
+using StructuralScanFn = void (*)(const char* data, size_t length, std::vector<uint32_t>& offsets);
+
+inline bool isStructural(char c) { return c == ',' || c == '\n' || c == '\r'; }
+
+inline void scanStructuralScalar(const char* data, size_t length, std::vector<uint32_t>& offsets) {
+    for (size_t i = 0; i < length; ++i) {
+        if (isStructural(data[i])) offsets.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+#ifdef CPU_X86
+
+inline int countTrailingZeros64(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+#ifdef _M_X64
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask))) return static_cast<int>(index);
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<int>(index) + 32;
+#endif
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Expands a 64-bit match mask for the block at base into offsets
+inline void appendMaskOffsets(uint64_t mask, size_t base, std::vector<uint32_t>& offsets) {
+    while (mask) {
+        offsets.push_back(static_cast<uint32_t>(base + countTrailingZeros64(mask)));
+        mask &= mask - 1;
+    }
+}
+
+CPU_TARGET_AVX2 inline void scanStructuralAvx2(const char* data, size_t length, std::vector<uint32_t>& offsets) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i lm = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline)),
+                                     _mm256_cmpeq_epi8(lo, carriage));
+        __m256i hm = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline)),
+                                     _mm256_cmpeq_epi8(hi, carriage));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(lm))
+                      | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hm))) << 32);
+        appendMaskOffsets(mask, i, offsets);
+    }
+    for (; i < length; ++i) {
+        if (isStructural(data[i])) offsets.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+CPU_TARGET_SSE2 inline void scanStructuralSse2(const char* data, size_t length, std::vector<uint32_t>& offsets) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        uint64_t mask = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lane * 16));
+            __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline)),
+                                     _mm_cmpeq_epi8(v, carriage));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(m))) << (lane * 16);
+        }
+        appendMaskOffsets(mask, i, offsets);
+    }
+    for (; i < length; ++i) {
+        if (isStructural(data[i])) offsets.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+#endif // CPU_X86
+
+// Best scanner for this CPU, chosen once at startup
+struct StructuralScanner {
+    StructuralScanFn scan;
+    const char* name;
+};
+
+inline StructuralScanner selectStructuralScanner() {
+#ifdef CPU_X86
+    if (cpuHasAvx2()) return { scanStructuralAvx2, "avx2" };
+    if (cpuHasSse2()) return { scanStructuralSse2, "sse2" };
+#endif
+    return { scanStructuralScalar, "scalar" };
+}
+
+inline const StructuralScanner ACTIVE_SCANNER = selectStructuralScanner();
+
+// Field text with surrounding spaces/tabs removed
+inline std::string_view trimField(std::string_view text) {
+    size_t begin = 0, end = text.size();
+    while (begin < end && (text[begin] == ' ' || text[begin] == '\t')) ++begin;
+    while (end > begin && (text[end - 1] == ' ' || text[end - 1] == '\t')) --end;
+    return text.substr(begin, end - begin);
+}
+
+// Splits a single row into trimmed fields; stops at the first line terminator
+inline void splitRow(std::string_view row, std::vector<std::string_view>& fields) {
+    std::vector<uint32_t> offsets;
+    ACTIVE_SCANNER.scan(row.data(), row.size(), offsets);
+    fields.clear();
+    size_t start = 0;
+    for (uint32_t at : offsets) {
+        fields.push_back(trimField(row.substr(start, at - start)));
+        start = at + 1;
+        if (row[at] != ',') return;
+    }
+    fields.push_back(trimField(row.substr(start)));
+}
+
+// Streams rows out of a CSV file. The file is read in large blocks, each block
+// is scanned once for structural bytes, and rows are returned as views into
+// the block; a row cut off at the end of a block is carried into the next.
+class CsvReader {
+private:
+    static const size_t BLOCK_BYTES = 1 << 20;
+
+    std::istream& in;
+    std::vector<char> buffer;       // Current block (plus carried partial row)
+    size_t dataLength = 0;          // Valid bytes in buffer
+    std::vector<uint32_t> offsets;  // Structural byte offsets within buffer
+    size_t nextOffset = 0;          // First offset not yet consumed
+    size_t rowStart = 0;            // Start of the first unconsumed row
+    bool atEnd = false;             // Input exhausted
+    uint64_t bufferFileOffset = 0;  // File offset of buffer[0]
+    uint64_t lastRowOffset = 0;     // File offset of the row last returned
+    size_t lastRowLength = 0;       // Its length, excluding the line terminator
+
+    std::string_view field(size_t begin, size_t end) const {
+        return trimField(std::string_view(buffer.data() + begin, end - begin));
+    }
+
+    // Keeps the unconsumed tail, reads the next block after it and rescans
+    void refill() {
+        size_t carried = dataLength - rowStart;
+        bufferFileOffset += rowStart;
+        if (carried > 0 && rowStart > 0) memmove(buffer.data(), buffer.data() + rowStart, carried);
+        if (buffer.size() < carried + BLOCK_BYTES) buffer.resize(carried + BLOCK_BYTES); // row longer than a block
+        in.read(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - carried));
+        size_t got = static_cast<size_t>(in.gcount());
+        atEnd = got == 0 || !in;
+        dataLength = carried + got;
+        rowStart = 0;
+        offsets.clear();
+        nextOffset = 0;
+        ACTIVE_SCANNER.scan(buffer.data(), dataLength, offsets);
+    }
+
+public:
+    explicit CsvReader(std::istream& input) : in(input), buffer(BLOCK_BYTES) {
+        refill();
+    }
+
+    // Fills fields with the next non-blank row; views stay valid until the next call
+    bool NextRow(std::vector<std::string_view>& fields) {
+        while (true) {
+            fields.clear();
+            size_t fieldStart = rowStart;
+            size_t rowEnd = 0;
+            bool rowDone = false;
+            while (nextOffset < offsets.size()) {
+                size_t at = offsets[nextOffset++];
+                fields.push_back(field(fieldStart, at));
+                fieldStart = at + 1;
+                if (buffer[at] != ',') { // '\n' or '\r' ends the row
+                    rowEnd = at;
+                    rowDone = true;
+                    break;
+                }
+            }
+            if (!rowDone) {
+                if (!atEnd) {
+                    refill();
+                    continue;
+                }
+                if (rowStart >= dataLength) return false;
+                fields.push_back(field(fieldStart, dataLength)); // last row without a newline
+                fieldStart = rowEnd = dataLength;
+            }
+            lastRowOffset = bufferFileOffset + rowStart;
+            lastRowLength = rowEnd - rowStart;
+            rowStart = fieldStart;
+            if (fields.size() == 1 && fields[0].empty()) continue; // blank line or the '\n' of "\r\n"
+            return true;
+        }
+    }
+
+    // File position of the row returned by the last NextRow, for re-reading it later
+    uint64_t RowOffset() const { return lastRowOffset; }
+    size_t RowLength() const { return lastRowLength; }
+};
@@ -0,0 +1,240 @@
+//============================================================================
+// Name        : DegreePlanner.h
+// Author      : Sonny Coutu
+// Description : Plans the fewest terms needed to reach target courses with at
+//               most a given number of courses per term. The prerequisite
+//               graph is resolved and topologically ordered once; each plan
+//               takes the prerequisite closure of its targets, reads it off
+//               the global order through a position bitmap, computes
+//               longest-path depths in topological order, and list-schedules
+//               the longest remaining chains first. Cohorts plan in parallel.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <bit>
+#include <queue>
+#include <unordered_map>
+
+// What a student wants to reach and what they have already passed
+struct PlanRequest {
+    vector<string> targets;
+    vector<string> completed;
+};
+
+struct TermPlan {
+    vector<vector<string>> terms;   // Courses to take each term, in ID order
+    size_t criticalPath = 0;        // Fewest terms possible without a per-term cap
+    vector<string> problems;        // Targets or prerequisites that cannot be planned
+};
+
+class DegreePlanner {
+private:
+    static constexpr uint32_t NONE = numeric_limits<uint32_t>::max();
+    static constexpr uint32_t DONE = NONE - 1;
+
+    vector<string> ids;                         // Slot -> course ID, in key order
+    unordered_map<string, uint32_t> slotOf;     // Course ID -> slot
+    vector<uint32_t> prereqStart;               // Prerequisites of slot c that are in the catalog:
+    vector<uint32_t> prereqList;                //   prereqList[prereqStart[c], prereqStart[c + 1])
+    unordered_map<uint32_t, vector<string>> missingPrereqs; // Prerequisites not in the catalog
+    vector<uint32_t> topoPos;                   // Position in a topological order; NONE on a cycle
+    vector<uint32_t> topoOrder;                 // Topological position -> slot
+
+    // Per-worker slot -> plan-local index map and topological-position bitmap,
+    // both reset after every plan
+    struct Scratch {
+        vector<uint32_t> local;
+        vector<uint64_t> marked;
+    };
+
+    Scratch makeScratch() const {
+        return Scratch{ vector<uint32_t>(ids.size(), NONE), vector<uint64_t>((topoOrder.size() + 63) / 64, 0) };
+    }
+
+    TermPlan planOne(const PlanRequest& request, size_t cap, Scratch& scratch) const {
+        TermPlan plan;
+        vector<uint32_t>& local = scratch.local;
+        vector<uint32_t> touched;
+        for (const string& id : request.completed) {
+            auto it = slotOf.find(id);
+            if (it != slotOf.end() && local[it->second] == NONE) {
+                local[it->second] = DONE;
+                touched.push_back(it->second);
+            }
+        }
+
+        // Prerequisite closure of the targets, stopping at completed courses
+        vector<uint32_t> needed, stack;
+        for (const string& id : request.targets) {
+            auto it = slotOf.find(id);
+            if (it == slotOf.end()) plan.problems.push_back(id + " is not in the catalog");
+            else stack.push_back(it->second);
+        }
+        while (!stack.empty()) {
+            uint32_t c = stack.back();
+            stack.pop_back();
+            if (local[c] != NONE) continue;
+            local[c] = static_cast<uint32_t>(needed.size());
+            needed.push_back(c);
+            touched.push_back(c);
+            for (uint32_t i = prereqStart[c]; i < prereqStart[c + 1]; ++i) {
+                if (local[prereqList[i]] == NONE) stack.push_back(prereqList[i]);
+            }
+        }
+
+        // Longest-path depth (earliest possible term) in topological order, and
+        // height (longest chain still to come) in reverse; courses on a cycle
+        // have no topological position and are left out. The closure is marked
+        // by position and read back off the global order, so it needs no sort
+        vector<uint64_t>& marked = scratch.marked;
+        size_t lowWord = marked.size(), highWord = 0;
+        for (uint32_t c : needed) {
+            if (topoPos[c] == NONE) continue;
+            size_t w = topoPos[c] / 64;
+            marked[w] |= uint64_t(1) << (topoPos[c] % 64);
+            lowWord = min(lowWord, w);
+            highWord = max(highWord, w + 1);
+        }
+        vector<uint32_t> order;
+        for (size_t w = lowWord; w < highWord; ++w) {
+            for (uint64_t bits = marked[w]; bits; bits &= bits - 1) {
+                order.push_back(topoOrder[w * 64 + countr_zero(bits)]);
+            }
+            marked[w] = 0;
+        }
+        size_t n = needed.size();
+        vector<uint32_t> depth(n, 0), height(n, 1), waitingOn(n, 0);
+        vector<vector<uint32_t>> unlocks(n);
+        for (uint32_t c : order) {
+            uint32_t lc = local[c];
+            for (uint32_t i = prereqStart[c]; i < prereqStart[c + 1]; ++i) {
+                uint32_t lp = local[prereqList[i]];
+                if (lp == DONE) continue;
+                depth[lc] = max(depth[lc], depth[lp] + 1);
+                unlocks[lp].push_back(lc);
+                ++waitingOn[lc];
+            }
+            if (missingPrereqs.count(c)) ++waitingOn[lc]; // never becomes ready
+            plan.criticalPath = max<size_t>(plan.criticalPath, depth[lc] + 1);
+        }
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            uint32_t lc = local[*it];
+            for (uint32_t ld : unlocks[lc]) height[lc] = max(height[lc], height[ld] + 1);
+        }
+
+        // List scheduling: each term takes up to cap ready courses, longest
+        // remaining chain first, then ID order
+        auto later = [&](uint32_t a, uint32_t b) {
+            return height[a] != height[b] ? height[a] < height[b] : needed[a] > needed[b];
+        };
+        priority_queue<uint32_t, vector<uint32_t>, decltype(later)> ready(later);
+        for (uint32_t c : order) {
+            if (waitingOn[local[c]] == 0) ready.push(local[c]);
+        }
+        size_t scheduled = 0;
+        vector<uint32_t> taken;
+        while (!ready.empty()) {
+            taken.clear();
+            while (!ready.empty() && taken.size() < cap) {
+                taken.push_back(ready.top());
+                ready.pop();
+            }
+            vector<string>& term = plan.terms.emplace_back();
+            for (uint32_t lc : taken) term.push_back(ids[needed[lc]]);
+            sort(term.begin(), term.end());
+            for (uint32_t lc : taken) {
+                for (uint32_t ld : unlocks[lc]) {
+                    if (--waitingOn[ld] == 0) ready.push(ld);
+                }
+            }
+            scheduled += taken.size();
+        }
+
+        if (scheduled < n) {
+            vector<string> blocked;
+            for (uint32_t c : needed) {
+                if (topoPos[c] == NONE) blocked.push_back(ids[c] + " is on or behind a prerequisite cycle");
+                else if (missingPrereqs.count(c)) {
+                    for (const string& id : missingPrereqs.at(c)) blocked.push_back(ids[c] + " requires " + id + ", which is not in the catalog");
+                }
+            }
+            sort(blocked.begin(), blocked.end());
+            plan.problems.insert(plan.problems.end(), blocked.begin(), blocked.end());
+            plan.problems.push_back(to_string(n - scheduled) + " required courses could not be scheduled");
+        }
+        for (uint32_t c : touched) local[c] = NONE;
+        return plan;
+    }
+
+public:
+    // Resolves prerequisites against the catalog and orders it topologically
+    void Build(const BinarySearchTree& catalog) {
+        ids.clear();
+        slotOf.clear();
+        missingPrereqs.clear();
+        vector<const Course*> courses;
+        catalog.ForEach([&](const Course& c) {
+            slotOf[c.courseNumber] = static_cast<uint32_t>(ids.size());
+            ids.push_back(c.courseNumber);
+            courses.push_back(&c);
+        });
+
+        uint32_t n = static_cast<uint32_t>(ids.size());
+        prereqStart.assign(1, 0);
+        prereqList.clear();
+        vector<uint32_t> waitingOn(n, 0);
+        vector<vector<uint32_t>> unlocks(n);
+        for (uint32_t c = 0; c < n; ++c) {
+            for (const string& pre : courses[c]->preReqs) {
+                auto it = slotOf.find(pre);
+                if (it == slotOf.end()) missingPrereqs[c].push_back(pre);
+                else if (find(prereqList.begin() + prereqStart[c], prereqList.end(), it->second) == prereqList.end()) {
+                    prereqList.push_back(it->second);
+                    unlocks[it->second].push_back(c);
+                    ++waitingOn[c];
+                }
+            }
+            prereqStart.push_back(static_cast<uint32_t>(prereqList.size()));
+        }
+
+        // Kahn's algorithm; whatever is never released sits on or behind a cycle
+        topoPos.assign(n, NONE);
+        vector<uint32_t> queue;
+        for (uint32_t c = 0; c < n; ++c) {
+            if (waitingOn[c] == 0) queue.push_back(c);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t c = queue[head];
+            topoPos[c] = static_cast<uint32_t>(head);
+            for (uint32_t d : unlocks[c]) {
+                if (--waitingOn[d] == 0) queue.push_back(d);
+            }
+        }
+        topoOrder = move(queue);
+    }
+
+    // Plans one student; cap is the most courses per term (0 for no limit)
+    TermPlan Plan(const PlanRequest& request, size_t cap) const {
+        Scratch scratch = makeScratch();
+        return planOne(request, cap ? cap : numeric_limits<size_t>::max(), scratch);
+    }
+
+    // Plans a whole cohort, spread across hardware threads
+    vector<TermPlan> PlanBatch(const vector<PlanRequest>& requests, size_t cap) const {
+        vector<TermPlan> plans(requests.size());
+        size_t workers = min<size_t>(requests.size(), max(1u, thread::hardware_concurrency()));
+        if (cap == 0) cap = numeric_limits<size_t>::max();
+        auto work = [&](size_t worker) {
+            Scratch scratch = makeScratch();
+            for (size_t i = worker; i < requests.size(); i += workers) plans[i] = planOne(requests[i], cap, scratch);
+        };
+        vector<future<void>> running;
+        for (size_t w = 1; w < workers; ++w) running.push_back(async(launch::async, work, w));
+        if (workers > 0) work(0);
+        for (future<void>& f : running) f.get();
+        return plans;
+    }
+};
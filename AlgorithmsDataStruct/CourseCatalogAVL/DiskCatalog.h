@@ -0,0 +1,928 @@
+//============================================================================
+// Name        : DiskCatalog.h
+// Author      : Sonny Coutu
+// Description : Disk-resident B+-tree catalog for catalogs larger than memory.
+//               Every node is a 4 KiB page of one file, and only the pages in
+//               a fixed-size buffer pool (CLOCK eviction) are held in memory.
+//               A lookup touches Height() pages, so its I/O is bounded by the
+//               tree height and is usually less, because the root and upper
+//               levels stay cached. An ordered scan reads each leaf once.
+//               Satisfies the ordered-index operations in OrderedIndex.h.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <cstring>
+
+// ---------------- Buffer pool ----------------
+
+// Fixed number of page frames over one file. A page is read on first use
+// and stays resident until the CLOCK hand finds it unpinned and not
+// referenced since the last sweep; dirty pages are written back then.
+// A failed write or a short read of an existing page sets Failed(); from
+// then on nothing more is written, so a bad read cannot spread into the file.
+class PageCache {
+public:
+    static const size_t PAGE_SIZE = 4096;
+
+    struct Stats {
+        size_t hits = 0;    // Pins served from memory
+        size_t reads = 0;   // Pages read from the file
+        size_t writes = 0;  // Pages written back
+    };
+
+private:
+    struct Frame {
+        uint32_t page = 0;
+        bool used = false;
+        bool dirty = false;
+        bool referenced = false;
+        int pins = 0;
+    };
+
+    fstream file;
+    vector<char> memory;                    // frames.size() pages
+    vector<Frame> frames;
+    unordered_map<uint32_t, size_t> resident; // Page -> frame holding it
+    size_t hand = 0;
+    Stats stats;
+    bool failed = false;
+
+    void writeBack(Frame& frame) {
+        frame.dirty = false;
+        if (failed) return;
+        file.clear();
+        file.seekp(static_cast<streamoff>(frame.page) * PAGE_SIZE);
+        file.write(&memory[(&frame - frames.data()) * PAGE_SIZE], PAGE_SIZE);
+        if (!file) failed = true;
+        ++stats.writes;
+    }
+
+    // Unpinned frame to reuse, writing back what it held
+    size_t victim() {
+        for (size_t sweep = 0; sweep < 2 * frames.size() + 1; ++sweep) {
+            Frame& frame = frames[hand];
+            size_t index = hand;
+            hand = (hand + 1) % frames.size();
+            if (!frame.used) return index;
+            if (frame.pins > 0) continue;
+            if (frame.referenced) {
+                frame.referenced = false;
+                continue;
+            }
+            if (frame.dirty) writeBack(frame);
+            resident.erase(frame.page);
+            frame.used = false;
+            return index;
+        }
+        return frames.size(); // every frame pinned
+    }
+
+public:
+    // Opens (or with truncate, replaces) the file and sets aside cachePages frames
+    bool Open(const string& filePath, size_t cachePages, bool truncate) {
+        Close();
+        ios::openmode mode = ios::in | ios::out | ios::binary;
+        if (!truncate) file.open(filePath, mode);
+        if (!file.is_open()) file.open(filePath, mode | ios::trunc);
+        if (!file.is_open()) return false;
+        frames.assign(max<size_t>(cachePages, 8), Frame());
+        memory.assign(frames.size() * PAGE_SIZE, 0);
+        resident.clear();
+        hand = 0;
+        stats = Stats();
+        failed = false;
+        return true;
+    }
+
+    // Writes every dirty page; false if any write or read has failed
+    bool Flush() {
+        for (Frame& frame : frames) {
+            if (frame.used && frame.dirty) writeBack(frame);
+        }
+        if (!failed && !file.flush()) failed = true;
+        return !failed;
+    }
+
+    bool Close() {
+        if (!file.is_open()) return true;
+        bool ok = Flush();
+        file.close();
+        if (file.fail()) ok = false;
+        frames.clear();
+        memory.clear();
+        resident.clear();
+        return ok;
+    }
+
+    bool IsOpen() const { return file.is_open(); }
+    bool Failed() const { return failed; }
+
+    // True if the file holds no pages yet
+    bool FileEmpty() {
+        file.clear();
+        file.seekg(0, ios::end);
+        return file.tellg() == streampos(0);
+    }
+
+    // Frame holding page, pinned until Unpin. A fresh page (just allocated
+    // past the end of the file) is zeroed instead of read. An existing page
+    // that cannot be read in full is left zeroed and sets Failed().
+    size_t Pin(uint32_t page, bool fresh = false) {
+        auto it = resident.find(page);
+        if (it != resident.end()) {
+            Frame& frame = frames[it->second];
+            ++frame.pins;
+            frame.referenced = true;
+            ++stats.hits;
+            return it->second;
+        }
+        size_t index = victim();
+        if (index == frames.size()) { // callers pin a few pages at a time, so this is a bug
+            cout << "Page cache exhausted: every frame is pinned." << endl;
+            abort();
+        }
+        Frame& frame = frames[index];
+        char* data = &memory[index * PAGE_SIZE];
+        memset(data, 0, PAGE_SIZE);
+        if (!fresh) {
+            file.clear();
+            file.seekg(static_cast<streamoff>(page) * PAGE_SIZE);
+            file.read(data, PAGE_SIZE);
+            if (file.gcount() != static_cast<streamsize>(PAGE_SIZE)) failed = true;
+            ++stats.reads;
+        }
+        frame = Frame{ page, true, fresh, true, 1 };
+        resident[page] = index;
+        return index;
+    }
+
+    void Unpin(size_t index, bool dirty) {
+        Frame& frame = frames[index];
+        frame.dirty = frame.dirty || dirty;
+        --frame.pins;
+    }
+
+    char* Data(size_t index) { return &memory[index * PAGE_SIZE]; }
+
+    size_t Frames() const { return frames.size(); }
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+};
+
+// ---------------- Disk B+-tree ----------------
+
+// Page 0 is the file header; every other page is a tree node or free:
+//   0  u8   kind (LEAF, INTERNAL or FREE)
+//   2  u16  cell count
+//   4  u32  link: next leaf (leaf), leftmost child (internal), next free page
+//   8  u16  slots[count]: byte offset of each cell, in key order
+//   cells are stored from the end of the page down towards the slots; an
+//   in-place delete leaves a gap that the next full rewrite closes
+// Leaf cell:     u16 ID length, ID, u16 name length, name, u16 prerequisite
+//                count, then u16 length and bytes of each prerequisite
+// Internal cell: u16 key length, key, u32 child holding keys >= key
+// Integers are in host byte order, so a file moves between machines of the
+// same endianness only.
+class DiskCatalog {
+public:
+    static const size_t PAGE_SIZE = PageCache::PAGE_SIZE;
+    static const size_t DEFAULT_CACHE_PAGES = 256;             // 1 MiB of frames
+    static const size_t MAX_CELL = (PAGE_SIZE - 16) / 4;        // Largest encoded course, so a split always fits
+
+private:
+    enum PageKind : uint8_t { FREE = 0, LEAF = 1, INTERNAL = 2 };
+    static const size_t NODE_HEADER = 8;
+    static const size_t UNDERFLOW_BYTES = PAGE_SIZE / 3;       // Rebalance a node below this
+    static const size_t BULK_FILL_BYTES = PAGE_SIZE * 7 / 8;   // Room left in bulk-loaded pages for inserts
+    static constexpr char MAGIC[8] = { 'C', 'C', 'A', 'T', 'P', 'G', '0', '1' };
+
+    // File header (page 0)
+    struct Header {
+        char magic[8];
+        uint32_t pageSize;
+        uint32_t root;
+        uint32_t pageCount;
+        uint32_t freeHead;  // First page of the free list, 0 if none
+        uint32_t height;
+        uint32_t reserved;
+        uint64_t size;
+    };
+
+    // Decoded node, used while a node is being changed
+    struct NodeImage {
+        bool leaf = true;
+        uint32_t link = 0;
+        vector<string> cells; // Encoded cells in key order
+    };
+
+    mutable PageCache cache;  // Lookups and scans page data in and out
+    string path;
+    Header header{};
+    mutable Course found;     // Storage behind the pointer Find returns
+    bool failureReported = false;
+
+    static uint16_t getU16(const char* p) { uint16_t v; memcpy(&v, p, sizeof(v)); return v; }
+    static uint32_t getU32(const char* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+    static void putU16(char* p, uint16_t v) { memcpy(p, &v, sizeof(v)); }
+    static void putU32(char* p, uint32_t v) { memcpy(p, &v, sizeof(v)); }
+
+    static void appendU16(string& out, size_t v) {
+        char bytes[2];
+        putU16(bytes, static_cast<uint16_t>(v));
+        out.append(bytes, 2);
+    }
+
+    static void appendText(string& out, const string& text) {
+        appendU16(out, text.size());
+        out += text;
+    }
+
+    static string encodeCourse(const Course& c) {
+        string cell;
+        appendText(cell, c.courseNumber);
+        appendText(cell, c.courseName);
+        appendU16(cell, c.preReqs.size());
+        for (const string& pre : c.preReqs) appendText(cell, pre);
+        return cell;
+    }
+
+    static void decodeCourse(const char* cell, Course& c) {
+        auto readText = [&cell](string& text) {
+            uint16_t length = getU16(cell);
+            text.assign(cell + 2, length);
+            cell += 2 + length;
+        };
+        readText(c.courseNumber);
+        readText(c.courseName);
+        uint16_t count = getU16(cell);
+        cell += 2;
+        c.preReqs.resize(count);
+        for (string& pre : c.preReqs) readText(pre);
+    }
+
+    static string internalCell(string_view key, uint32_t child) {
+        string cell;
+        appendU16(cell, key.size());
+        cell += key;
+        char bytes[4];
+        putU32(bytes, child);
+        cell.append(bytes, 4);
+        return cell;
+    }
+
+    // Both cell kinds start with the key
+    static string_view cellKey(const char* cell) { return string_view(cell + 2, getU16(cell)); }
+    static string_view cellKey(const string& cell) { return cellKey(cell.data()); }
+    static uint32_t cellChild(const string& cell) { return getU32(cell.data() + cell.size() - 4); }
+
+    static uint16_t cellCount(const char* page) { return getU16(page + 2); }
+
+    // Cells are self-delimiting: a leaf cell is walked field by field
+    static size_t cellSize(const char* cell, bool leaf) {
+        const char* p = cell + 2 + getU16(cell);
+        if (!leaf) return p + 4 - cell;
+        p += 2 + getU16(p);
+        size_t count = getU16(p);
+        p += 2;
+        for (size_t i = 0; i < count; ++i) p += 2 + getU16(p);
+        return p - cell;
+    }
+
+    // Bytes in use by a page: header, slots and live cells
+    static size_t pageBytes(const char* page) {
+        size_t bytes = NODE_HEADER;
+        for (size_t i = 0; i < cellCount(page); ++i) bytes += 2 + cellSize(cellAt(page, i), page[0] == LEAF);
+        return bytes;
+    }
+    static const char* cellAt(const char* page, size_t i) { return page + getU16(page + NODE_HEADER + 2 * i); }
+
+    static size_t usedBytes(const NodeImage& node) {
+        size_t bytes = NODE_HEADER;
+        for (const string& cell : node.cells) bytes += 2 + cell.size();
+        return bytes;
+    }
+
+    static bool fits(const NodeImage& node) { return usedBytes(node) <= PAGE_SIZE; }
+
+    // Child to descend into for key, from the page bytes without decoding
+    static uint32_t childFor(const char* page, string_view key) {
+        size_t lo = 0, hi = cellCount(page);
+        while (lo < hi) { // first separator greater than key
+            size_t mid = (lo + hi) / 2;
+            if (cellKey(cellAt(page, mid)) <= key) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == 0) return getU32(page + 4);
+        const char* cell = cellAt(page, lo - 1);
+        return getU32(cell + 2 + getU16(cell));
+    }
+
+    // Slot of the first leaf cell whose key is not less than key
+    static size_t lowerBound(const char* page, string_view key) {
+        size_t lo = 0, hi = cellCount(page);
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (cellKey(cellAt(page, mid)) < key) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    NodeImage readNode(uint32_t page) {
+        size_t frame = cache.Pin(page);
+        const char* data = cache.Data(frame);
+        NodeImage node;
+        node.leaf = data[0] == LEAF;
+        node.link = getU32(data + 4);
+        size_t count = cellCount(data);
+        node.cells.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const char* cell = cellAt(data, i);
+            node.cells.emplace_back(cell, cellSize(cell, node.leaf));
+        }
+        cache.Unpin(frame, false);
+        return node;
+    }
+
+    // Rewrites the whole page, packing the cells against its end
+    void writeNode(uint32_t page, const NodeImage& node, bool fresh = false) {
+        size_t frame = cache.Pin(page, fresh);
+        char* data = cache.Data(frame);
+        memset(data, 0, PAGE_SIZE);
+        data[0] = static_cast<char>(node.leaf ? LEAF : INTERNAL);
+        putU16(data + 2, static_cast<uint16_t>(node.cells.size()));
+        putU32(data + 4, node.link);
+        size_t end = PAGE_SIZE;
+        for (size_t i = 0; i < node.cells.size(); ++i) {
+            end -= node.cells[i].size();
+            memcpy(data + end, node.cells[i].data(), node.cells[i].size());
+            putU16(data + NODE_HEADER + 2 * i, static_cast<uint16_t>(end));
+        }
+        cache.Unpin(frame, true);
+    }
+
+    uint32_t allocatePage(bool& fresh) {
+        if (header.freeHead) {
+            uint32_t page = header.freeHead;
+            size_t frame = cache.Pin(page);
+            header.freeHead = getU32(cache.Data(frame) + 4);
+            cache.Unpin(frame, false);
+            fresh = false;
+            return page;
+        }
+        fresh = true;
+        return header.pageCount++;
+    }
+
+    void freePage(uint32_t page) {
+        size_t frame = cache.Pin(page);
+        char* data = cache.Data(frame);
+        memset(data, 0, PAGE_SIZE);
+        data[0] = FREE;
+        putU32(data + 4, header.freeHead);
+        cache.Unpin(frame, true);
+        header.freeHead = page;
+    }
+
+    // Writes a new node to a newly allocated page and returns the page
+    uint32_t newNode(const NodeImage& node) {
+        bool fresh = false;
+        uint32_t page = allocatePage(fresh);
+        writeNode(page, node, fresh);
+        return page;
+    }
+
+    // Index splitting cells into two runs of about equal bytes, each non-empty
+    static size_t splitPoint(const vector<string>& cells, size_t minRight) {
+        size_t total = 0;
+        for (const string& cell : cells) total += 2 + cell.size();
+        size_t bytes = 0, i = 0;
+        while (i + minRight < cells.size() && bytes < total / 2) bytes += 2 + cells[i++].size();
+        return max<size_t>(i, 1);
+    }
+
+    void writeHeader() {
+        size_t frame = cache.Pin(0);
+        memcpy(cache.Data(frame), &header, sizeof(header));
+        cache.Unpin(frame, true);
+    }
+
+    // Adds a cell to a leaf page without decoding it when the gap between
+    // the slots and the lowest cell can take it; false means the leaf must
+    // be rewritten (compacted or split) instead
+    bool insertInPlace(uint32_t page, const string& key, const string& cell, bool& inserted) {
+        size_t frame = cache.Pin(page);
+        char* data = cache.Data(frame);
+        size_t count = cellCount(data);
+        size_t slot = lowerBound(data, key);
+        if (slot < count && cellKey(cellAt(data, slot)) == key) {
+            cache.Unpin(frame, false);
+            inserted = false; // No duplicates allowed
+            return true;
+        }
+        size_t low = PAGE_SIZE;
+        for (size_t i = 0; i < count; ++i) low = min<size_t>(low, getU16(data + NODE_HEADER + 2 * i));
+        if (low < NODE_HEADER + 2 * (count + 1) + cell.size()) {
+            cache.Unpin(frame, false);
+            return false;
+        }
+        low -= cell.size();
+        memcpy(data + low, cell.data(), cell.size());
+        char* slots = data + NODE_HEADER;
+        memmove(slots + 2 * (slot + 1), slots + 2 * slot, 2 * (count - slot));
+        putU16(slots + 2 * slot, static_cast<uint16_t>(low));
+        putU16(data + 2, static_cast<uint16_t>(count + 1));
+        cache.Unpin(frame, true);
+        inserted = true;
+        return true;
+    }
+
+    // Inserts into the subtree at page. On overflow the node splits and the
+    // new right sibling's page is returned along with its separator key.
+    uint32_t insertRec(uint32_t page, const Course& c, const string& cell, bool& inserted, string& separator) {
+        size_t frame = cache.Pin(page);
+        const char* data = cache.Data(frame);
+        bool leaf = data[0] == LEAF;
+        uint32_t child = leaf ? 0 : childFor(data, c.courseNumber);
+        cache.Unpin(frame, false);
+
+        if (leaf) {
+            if (insertInPlace(page, c.courseNumber, cell, inserted)) return 0;
+            NodeImage node = readNode(page);
+            auto pos = lower_bound(node.cells.begin(), node.cells.end(), c.courseNumber,
+                [](const string& a, const string& key) { return cellKey(a) < key; });
+            if (pos != node.cells.end() && cellKey(*pos) == c.courseNumber) {
+                inserted = false; // No duplicates allowed
+                return 0;
+            }
+            node.cells.insert(pos, cell);
+            inserted = true;
+            if (fits(node)) {
+                writeNode(page, node);
+                return 0;
+            }
+            NodeImage right;
+            size_t mid = splitPoint(node.cells, 1);
+            right.cells.assign(make_move_iterator(node.cells.begin() + mid), make_move_iterator(node.cells.end()));
+            node.cells.resize(mid);
+            right.link = node.link;
+            uint32_t rightPage = newNode(right);
+            node.link = rightPage;
+            writeNode(page, node);
+            separator = string(cellKey(right.cells.front()));
+            return rightPage;
+        }
+
+        string childSeparator;
+        uint32_t split = insertRec(child, c, cell, inserted, childSeparator);
+        if (!split) return 0;
+        NodeImage node = readNode(page);
+        auto pos = upper_bound(node.cells.begin(), node.cells.end(), string_view(childSeparator),
+            [](string_view key, const string& a) { return key < cellKey(a); });
+        node.cells.insert(pos, internalCell(childSeparator, split));
+        if (fits(node)) {
+            writeNode(page, node);
+            return 0;
+        }
+        // The middle separator moves up; its child becomes the right node's leftmost
+        size_t mid = splitPoint(node.cells, 2);
+        NodeImage right;
+        right.leaf = false;
+        separator = string(cellKey(node.cells[mid]));
+        right.link = cellChild(node.cells[mid]);
+        right.cells.assign(make_move_iterator(node.cells.begin() + mid + 1), make_move_iterator(node.cells.end()));
+        node.cells.resize(mid);
+        uint32_t rightPage = newNode(right);
+        writeNode(page, node);
+        return rightPage;
+    }
+
+    // Child page at position i of an internal node (0 is the leftmost)
+    static uint32_t childAt(const NodeImage& node, size_t i) { return i == 0 ? node.link : cellChild(node.cells[i - 1]); }
+
+    // Refills child i of parent after it dropped below UNDERFLOW_BYTES, by
+    // merging it with a sibling when both fit in one page and otherwise
+    // evening out their bytes. Leaves it underfull, which is still valid,
+    // when a longer separator would no longer fit in the parent.
+    void rebalanceChild(NodeImage& parent, size_t i) {
+        if (parent.cells.empty()) return; // only child
+        size_t a = i > 0 ? i - 1 : i;    // left of the pair; the separator is parent.cells[a]
+        uint32_t leftPage = childAt(parent, a);
+        uint32_t rightPage = childAt(parent, a + 1);
+        NodeImage left = readNode(leftPage);
+        NodeImage right = readNode(rightPage);
+
+        NodeImage merged = left;
+        if (left.leaf) {
+            merged.cells.insert(merged.cells.end(), right.cells.begin(), right.cells.end());
+            merged.link = right.link;
+        }
+        else {
+            merged.cells.push_back(internalCell(cellKey(parent.cells[a]), right.link));
+            merged.cells.insert(merged.cells.end(), right.cells.begin(), right.cells.end());
+        }
+        if (fits(merged)) {
+            writeNode(leftPage, merged);
+            freePage(rightPage);
+            parent.cells.erase(parent.cells.begin() + a);
+            return;
+        }
+
+        NodeImage newLeft, newRight;
+        newLeft.leaf = newRight.leaf = left.leaf;
+        newLeft.link = left.link;
+        string newSeparator;
+        if (left.leaf) {
+            size_t mid = splitPoint(merged.cells, 1);
+            newLeft.cells.assign(merged.cells.begin(), merged.cells.begin() + mid);
+            newRight.cells.assign(merged.cells.begin() + mid, merged.cells.end());
+            newLeft.link = rightPage;
+            newRight.link = right.link;
+            newSeparator = string(cellKey(newRight.cells.front()));
+        }
+        else {
+            size_t mid = splitPoint(merged.cells, 2);
+            newLeft.cells.assign(merged.cells.begin(), merged.cells.begin() + mid);
+            newSeparator = string(cellKey(merged.cells[mid]));
+            newRight.link = cellChild(merged.cells[mid]);
+            newRight.cells.assign(merged.cells.begin() + mid + 1, merged.cells.end());
+        }
+        string oldSeparator = move(parent.cells[a]);
+        parent.cells[a] = internalCell(newSeparator, rightPage);
+        if (!fits(parent) || !fits(newLeft) || !fits(newRight)) {
+            parent.cells[a] = move(oldSeparator);
+            return;
+        }
+        writeNode(leftPage, newLeft);
+        writeNode(rightPage, newRight);
+    }
+
+    // Removes courseNumber from the subtree at page; underflow reports that
+    // the node now holds fewer than UNDERFLOW_BYTES
+    // Leaves are changed in place (the slot is dropped, the cell becomes a
+    // gap); an internal node is decoded only when a child needs rebalancing.
+    bool deleteRec(uint32_t page, const string& courseNumber, bool& underflow) {
+        size_t frame = cache.Pin(page);
+        char* data = cache.Data(frame);
+        if (data[0] == LEAF) {
+            size_t count = cellCount(data);
+            size_t slot = lowerBound(data, courseNumber);
+            bool found = slot < count && cellKey(cellAt(data, slot)) == courseNumber;
+            if (found) {
+                char* slots = data + NODE_HEADER;
+                memmove(slots + 2 * slot, slots + 2 * (slot + 1), 2 * (count - slot - 1));
+                putU16(data + 2, static_cast<uint16_t>(count - 1));
+                underflow = pageBytes(data) < UNDERFLOW_BYTES;
+            }
+            cache.Unpin(frame, found);
+            return found;
+        }
+        uint32_t child = childFor(data, courseNumber);
+        cache.Unpin(frame, false);
+
+        bool childUnderflow = false;
+        if (!deleteRec(child, courseNumber, childUnderflow)) return false;
+        if (childUnderflow) {
+            NodeImage node = readNode(page);
+            size_t i = upper_bound(node.cells.begin(), node.cells.end(), string_view(courseNumber),
+                [](string_view key, const string& a) { return key < cellKey(a); }) - node.cells.begin();
+            rebalanceChild(node, i);
+            writeNode(page, node);
+            underflow = usedBytes(node) < UNDERFLOW_BYTES;
+        }
+        return true;
+    }
+
+    // Leaf that holds key if it is present, one page read per level
+    uint32_t leafFor(string_view key) const {
+        uint32_t page = header.root;
+        for (uint32_t level = 1; level < header.height; ++level) {
+            size_t frame = cache.Pin(page);
+            page = childFor(cache.Data(frame), key);
+            cache.Unpin(frame, false);
+        }
+        return page;
+    }
+
+    // In key order, visit(course) for each course with ID >= from while it returns true
+    template <typename Visitor>
+    void scanFrom(const string& from, Visitor& visit) const {
+        if (!cache.IsOpen() || header.size == 0) return;
+        vector<Course> batch;
+        for (uint32_t page = leafFor(from); page;) {
+            size_t frame = cache.Pin(page);
+            const char* data = cache.Data(frame);
+            size_t first = lowerBound(data, from);
+            batch.resize(cellCount(data) - first);
+            for (size_t i = 0; i < batch.size(); ++i) decodeCourse(cellAt(data, first + i), batch[i]);
+            page = getU32(data + 4);
+            cache.Unpin(frame, false); // the visitor may look up other pages
+            for (const Course& c : batch) {
+                if (!visit(c)) return;
+            }
+        }
+    }
+
+    // ---------------- Bulk load ----------------
+    // Rows arriving in ascending ID order are packed bottom up, one open node
+    // per level, and each page is written once when it fills
+
+    struct BuildLevel {
+        NodeImage node;
+        uint32_t page = 0;
+        bool fresh = false;
+        string firstKey;    // Smallest key under the node
+        bool empty = true;
+    };
+    vector<BuildLevel> building;
+
+    void buildStart(BuildLevel& level, bool leaf) {
+        level.node = NodeImage();
+        level.node.leaf = leaf;
+        level.page = allocatePage(level.fresh);
+        level.empty = true;
+    }
+
+    // Closes the open node at depth (0 = leaves) and hands it to its parent level
+    void buildFlush(size_t depth, bool last) {
+        BuildLevel& level = building[depth];
+        uint32_t page = level.page;
+        string firstKey = level.firstKey;
+        if (level.node.leaf && !last) {
+            bool fresh = false;
+            uint32_t next = allocatePage(fresh);
+            level.node.link = next;
+            writeNode(page, level.node, level.fresh);
+            level.node = NodeImage();
+            level.page = next;
+            level.fresh = fresh;
+            level.empty = true;
+        }
+        else {
+            writeNode(page, level.node, level.fresh);
+            if (!last) buildStart(level, level.node.leaf);
+        }
+        buildAdd(depth + 1, firstKey, internalCell(firstKey, page), page);
+    }
+
+    // Adds a cell (leaves) or a child page (internal levels) to the open node at depth
+    void buildAdd(size_t depth, const string& key, const string& cell, uint32_t child) {
+        if (depth == building.size()) {
+            building.emplace_back();
+            buildStart(building.back(), depth == 0);
+        }
+        BuildLevel& level = building[depth];
+        if (level.empty) {
+            level.firstKey = key;
+            level.empty = false;
+            if (depth > 0) {
+                level.node.link = child;
+                return;
+            }
+        }
+        else if (usedBytes(level.node) + 2 + cell.size() > BULK_FILL_BYTES) {
+            buildFlush(depth, false);
+            buildAdd(depth, key, cell, child);
+            return;
+        }
+        level.node.cells.push_back(cell);
+    }
+
+    // Writes the partly filled nodes and makes the top one the root
+    void buildFinish() {
+        for (size_t depth = 0; depth < building.size(); ++depth) {
+            BuildLevel& level = building[depth];
+            if (depth + 1 == building.size()) {
+                if (depth > 0 && level.node.cells.empty()) { // a single child needs no node above it
+                    header.root = level.node.link;
+                    header.height = static_cast<uint32_t>(depth);
+                    freePage(level.page);
+                }
+                else {
+                    writeNode(level.page, level.node, level.fresh);
+                    header.root = level.page;
+                    header.height = static_cast<uint32_t>(depth + 1);
+                }
+                break;
+            }
+            buildFlush(depth, true);
+        }
+        building.clear();
+    }
+
+    bool initialize(const string& filePath, size_t cachePages, bool truncate) {
+        path = filePath;
+        failureReported = false;
+        if (!cache.Open(filePath, cachePages, truncate)) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return false;
+        }
+        size_t frame = cache.Pin(0, cache.FileEmpty());
+        memcpy(&header, cache.Data(frame), sizeof(header));
+        cache.Unpin(frame, false);
+        if (cache.Failed()) {
+            cout << "Could not read file (" << filePath << ")." << endl;
+            cache.Close();
+            header = Header{};
+            return false;
+        }
+        if (header.pageCount == 0) { // new file: header page and an empty root leaf
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.pageSize = PAGE_SIZE;
+            header.root = 1;
+            header.pageCount = 2;
+            header.height = 1;
+            writeNode(1, NodeImage(), true);
+            writeHeader();
+        }
+        else if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.pageSize != PAGE_SIZE) {
+            cout << "Not a catalog page file (" << filePath << ")." << endl;
+            cache.Close();
+            header = Header{};
+            return false;
+        }
+        return true;
+    }
+
+public:
+    DiskCatalog() {}
+    ~DiskCatalog() { Close(); }
+    DiskCatalog(const DiskCatalog&) = delete;
+    DiskCatalog& operator=(const DiskCatalog&) = delete;
+
+    // Opens an existing page file, or creates an empty one if it doesn't exist
+    bool Open(const string& filePath, size_t cachePages = DEFAULT_CACHE_PAGES) {
+        return initialize(filePath, cachePages, false);
+    }
+
+    // Creates an empty page file, replacing any existing one
+    bool Create(const string& filePath, size_t cachePages = DEFAULT_CACHE_PAGES) {
+        return initialize(filePath, cachePages, true);
+    }
+
+    // Writes the header and every dirty page; false (with a message) if the
+    // file could not be read or written since it was opened
+    bool Flush() {
+        if (!cache.IsOpen()) return false;
+        writeHeader();
+        if (cache.Flush()) return true;
+        if (!failureReported) cout << "Could not read or write file (" << path << ")." << endl;
+        failureReported = true;
+        return false;
+    }
+
+    bool Close() {
+        if (!cache.IsOpen()) return true;
+        bool ok = Flush();
+        return cache.Close() && ok;
+    }
+
+    // True once a page read or write has failed; the file is no longer written
+    bool Failed() const { return cache.Failed(); }
+
+    // False if the course is too large for a page or the file has failed
+    // (see Failed); a duplicate ID is ignored and still returns true
+    bool Insert(const Course& aCourse) {
+        if (!cache.IsOpen() || cache.Failed()) return false;
+        string cell = encodeCourse(aCourse);
+        if (cell.size() > MAX_CELL) {
+            cout << "Course " << aCourse.courseNumber << " is too large for a catalog page." << endl;
+            return false;
+        }
+        bool inserted = false;
+        string separator;
+        uint32_t split = insertRec(header.root, aCourse, cell, inserted, separator);
+        if (split) { // grow a new root
+            NodeImage newRoot;
+            newRoot.leaf = false;
+            newRoot.link = header.root;
+            newRoot.cells.push_back(internalCell(separator, split));
+            header.root = newNode(newRoot);
+            ++header.height;
+        }
+        if (inserted) ++header.size;
+        return !cache.Failed();
+    }
+
+    bool Delete(const string& courseNumber) {
+        if (!cache.IsOpen() || cache.Failed()) return false;
+        bool underflow = false;
+        if (!deleteRec(header.root, courseNumber, underflow)) return false;
+        NodeImage root = readNode(header.root);
+        if (!root.leaf && root.cells.empty()) { // shrink an empty root
+            freePage(header.root);
+            header.root = root.link;
+            --header.height;
+        }
+        --header.size;
+        return true;
+    }
+
+    // Reads Height() pages at most. The course is copied out of its page;
+    // the pointer stays valid until the next Find or Search.
+    const Course* Find(const string& courseNumber) const {
+        if (!cache.IsOpen()) return nullptr;
+        size_t frame = cache.Pin(leafFor(courseNumber));
+        const char* data = cache.Data(frame);
+        size_t slot = lowerBound(data, courseNumber);
+        bool hit = slot < cellCount(data) && cellKey(cellAt(data, slot)) == courseNumber;
+        if (hit) decodeCourse(cellAt(data, slot), found);
+        cache.Unpin(frame, false);
+        return hit ? &found : nullptr;
+    }
+
+    // Case-insensitive lookup by ID, like BinarySearchTree::Search
+    Course Search(string courseId) {
+        convertCase(courseId);
+        const Course* c = Find(courseId);
+        return c ? *c : Course();
+    }
+
+    // Visit every course in key order, one leaf page at a time
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        auto all = [&visit](const Course& c) { visit(c); return true; };
+        scanFrom("", all);
+    }
+
+    // Visit, in key order, every course whose ID starts with prefix
+    template <typename Visitor>
+    void ForEachPrefix(const string& prefix, Visitor visit) const {
+        auto matching = [&](const Course& c) {
+            if (c.courseNumber.compare(0, prefix.size(), prefix) != 0) return false;
+            visit(c);
+            return true;
+        };
+        scanFrom(prefix, matching);
+    }
+
+    void InOrder() const {
+        ForEach([](const Course& c) { cout << c.courseNumber << ", " << c.courseName << endl; });
+    }
+
+    // Loads a catalog CSV without holding it in memory. Into an empty catalog,
+    // rows in ascending ID order (as the catalog file is kept) are packed into
+    // pages bottom up; rows out of order, or rows for a catalog that already
+    // has courses, go through Insert. The first row for an ID wins. False if
+    // the file could not be read or the page file could not be written.
+    bool Load(const string& filePath) {
+        if (!cache.IsOpen() || cache.Failed()) return false;
+        ifstream inFS(filePath, ios::binary);
+        if (!inFS.is_open()) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return false;
+        }
+        bool packing = header.size == 0 && header.height == 1;
+        if (packing) freePage(header.root); // the empty root leaf
+        CsvReader reader(inFS);
+        vector<string_view> fields;
+        vector<Course> outOfOrder;
+        string lastKey;
+        while (reader.NextRow(fields) && !cache.Failed()) {
+            if (fields.size() < 2) continue;
+            Course aCourse{ string(fields[0]), string(fields[1]), {} };
+            for (size_t i = 2; i < fields.size(); ++i) {
+                if (!fields[i].empty()) aCourse.preReqs.emplace_back(fields[i]);
+            }
+            if (!packing) {
+                Insert(aCourse);
+                continue;
+            }
+            if (header.size > 0 && aCourse.courseNumber <= lastKey) {
+                if (aCourse.courseNumber < lastKey) outOfOrder.push_back(move(aCourse));
+                continue;
+            }
+            string cell = encodeCourse(aCourse);
+            if (cell.size() > MAX_CELL) {
+                cout << "Course " << aCourse.courseNumber << " is too large for a catalog page." << endl;
+                continue;
+            }
+            buildAdd(0, aCourse.courseNumber, cell, 0);
+            lastKey = aCourse.courseNumber;
+            ++header.size;
+        }
+        if (packing) {
+            if (building.empty()) { // no rows
+                header.root = newNode(NodeImage());
+                header.height = 1;
+            }
+            else buildFinish();
+        }
+        for (const Course& c : outOfOrder) Insert(c);
+        return Flush();
+    }
+
+    int Size() const { return static_cast<int>(header.size); }
+
+    // Levels from the root to the leaves; a lookup reads at most this many pages
+    int Height() const { return static_cast<int>(header.height); }
+
+    size_t PageCount() const { return header.pageCount; }
+    size_t CachePages() const { return cache.Frames(); }
+    const PageCache::Stats& CacheStats() const { return cache.GetStats(); }
+    void ResetCacheStats() { cache.ResetStats(); }
+    const string& Path() const { return path; }
+};
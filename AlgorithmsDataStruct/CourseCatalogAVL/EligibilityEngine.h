@@ -0,0 +1,149 @@
+//============================================================================
+// Name        : EligibilityEngine.h
+// Author      : Sonny Coutu
+// Description : "What can I take next?" for many students at once. Courses
+//               get dense indices and prerequisite lists; students are
+//               bit-sliced 256 to a block, so one AND per prerequisite tests
+//               a whole block (AVX2 where available). Blocks run in parallel.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+#include "CpuFeatures.h"
+
+#include <bit>
+#include <unordered_map>
+
+// One bit per student in a block of 256
+struct StudentBlock {
+    uint64_t lanes[4];
+};
+
+// ANDs the taken-sets of the given prerequisite slots into acc, clearing the
+// students who already took the course itself
+using SubsetTestFn = void (*)(const StudentBlock* taken, const uint32_t* prereqs, size_t count,
+                              uint32_t course, StudentBlock& acc);
+
+inline void subsetTestScalar(const StudentBlock* taken, const uint32_t* prereqs, size_t count,
+                             uint32_t course, StudentBlock& acc) {
+    for (size_t i = 0; i < count; ++i) {
+        const StudentBlock& t = taken[prereqs[i]];
+        for (int lane = 0; lane < 4; ++lane) acc.lanes[lane] &= t.lanes[lane];
+    }
+    for (int lane = 0; lane < 4; ++lane) acc.lanes[lane] &= ~taken[course].lanes[lane];
+}
+
+#ifdef CPU_X86
+CPU_TARGET_AVX2 inline void subsetTestAvx2(const StudentBlock* taken, const uint32_t* prereqs, size_t count,
+                                           uint32_t course, StudentBlock& acc) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc.lanes));
+    for (size_t i = 0; i < count; ++i) {
+        a = _mm256_and_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(taken[prereqs[i]].lanes)));
+    }
+    a = _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(taken[course].lanes)), a);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.lanes), a);
+}
+#endif
+
+inline SubsetTestFn selectSubsetTest() {
+#ifdef CPU_X86
+    if (cpuHasAvx2()) return subsetTestAvx2;
+#endif
+    return subsetTestScalar;
+}
+
+class EligibilityEngine {
+private:
+    static constexpr size_t BLOCK_STUDENTS = 256;
+
+    vector<string> slotIds;                    // Slot -> course ID; catalog courses first, in key order
+    unordered_map<string, uint32_t> slotOf;    // Course ID -> slot
+    uint32_t courseCount = 0;                  // Slots [0, courseCount) are catalog courses; the rest
+                                               // are prerequisites missing from the catalog
+    vector<uint32_t> prereqStart;              // Course c's prerequisite slots are
+    vector<uint32_t> prereqSlots;              //   prereqSlots[prereqStart[c], prereqStart[c + 1])
+    SubsetTestFn subsetTest = selectSubsetTest();
+
+    uint32_t slotFor(const string& id) {
+        auto it = slotOf.find(id);
+        if (it != slotOf.end()) return it->second;
+        slotIds.push_back(id);
+        return slotOf[id] = static_cast<uint32_t>(slotIds.size() - 1);
+    }
+
+    // Answers students [first, first + count) of the batch; count <= BLOCK_STUDENTS
+    void runBlock(const vector<vector<string>>& completedSets, size_t first, size_t count,
+                  vector<vector<uint32_t>>& results, vector<StudentBlock>& taken) const {
+        fill(taken.begin(), taken.end(), StudentBlock{});
+        for (size_t s = 0; s < count; ++s) {
+            for (const string& id : completedSets[first + s]) {
+                auto it = slotOf.find(id);
+                if (it != slotOf.end()) taken[it->second].lanes[s / 64] |= uint64_t(1) << (s % 64);
+            }
+        }
+        StudentBlock active{};
+        for (size_t s = 0; s < count; ++s) active.lanes[s / 64] |= uint64_t(1) << (s % 64);
+
+        for (uint32_t c = 0; c < courseCount; ++c) {
+            StudentBlock acc = active;
+            subsetTest(taken.data(), prereqSlots.data() + prereqStart[c], prereqStart[c + 1] - prereqStart[c], c, acc);
+            for (int lane = 0; lane < 4; ++lane) {
+                for (uint64_t bits = acc.lanes[lane]; bits; bits &= bits - 1) {
+                    results[first + lane * 64 + countr_zero(bits)].push_back(c);
+                }
+            }
+        }
+    }
+
+public:
+    // Indexes the catalog; call again after it changes
+    void Build(const BinarySearchTree& catalog) {
+        slotIds.clear();
+        slotOf.clear();
+        prereqStart.assign(1, 0);
+        prereqSlots.clear();
+        vector<const Course*> courses;
+        catalog.ForEach([&](const Course& c) {
+            slotOf[c.courseNumber] = static_cast<uint32_t>(slotIds.size());
+            slotIds.push_back(c.courseNumber);
+            courses.push_back(&c);
+        });
+        courseCount = static_cast<uint32_t>(slotIds.size());
+        for (const Course* c : courses) {
+            for (const string& pre : c->preReqs) prereqSlots.push_back(slotFor(pre));
+            prereqStart.push_back(static_cast<uint32_t>(prereqSlots.size()));
+        }
+    }
+
+    // For each student's completed course IDs, the courses not yet taken whose
+    // prerequisites are all completed (course indices in key order; see CourseNumber).
+    // Prerequisites missing from the catalog count once the student lists them.
+    vector<vector<uint32_t>> EligibleBatch(const vector<vector<string>>& completedSets) const {
+        vector<vector<uint32_t>> results(completedSets.size());
+        size_t blocks = (completedSets.size() + BLOCK_STUDENTS - 1) / BLOCK_STUDENTS;
+        size_t workers = min<size_t>(blocks, max(1u, thread::hardware_concurrency()));
+        auto work = [&](size_t worker) {
+            vector<StudentBlock> taken(slotIds.size());
+            for (size_t b = worker; b < blocks; b += workers) {
+                size_t first = b * BLOCK_STUDENTS;
+                runBlock(completedSets, first, min(BLOCK_STUDENTS, completedSets.size() - first), results, taken);
+            }
+        };
+        vector<future<void>> running;
+        for (size_t w = 1; w < workers; ++w) running.push_back(async(launch::async, work, w));
+        if (workers > 0) work(0);
+        for (future<void>& f : running) f.get();
+        return results;
+    }
+
+    vector<string> Eligible(const vector<string>& completed) const {
+        vector<string> ids;
+        vector<vector<uint32_t>> batch = EligibleBatch({ completed }); // keep the batch alive for the loop
+        for (uint32_t c : batch[0]) ids.push_back(slotIds[c]);
+        return ids;
+    }
+
+    const string& CourseNumber(uint32_t course) const { return slotIds[course]; }
+    uint32_t CourseCount() const { return courseCount; }
+};
@@ -0,0 +1,108 @@
+//============================================================================
+// Name        : EmbeddedCatalog.h
+// Author      : Sonny Coutu
+// Description : Read-only catalog compiled into the binary. CatalogEmbedGen
+//               turns a catalog CSV into a generated header of constexpr
+//               tables: the courses sorted by ID (ordered listing and prefix
+//               search by binary search) and a minimal perfect hash over the
+//               IDs (exact lookup in one probe). Nothing is parsed or
+//               allocated at startup or per lookup.
+//
+//               Perfect hash (hash and displace): each ID's 64-bit hash picks
+//               a bucket, and the bucket's seed was chosen by the generator so
+//               that every ID in it lands on a distinct, otherwise unused slot
+//               of an n-slot table. slots[] maps a slot to its course.
+//============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+struct EmbeddedCourse {
+    std::string_view id;
+    std::string_view name;
+    uint32_t firstPrereq;   // Index of its first prerequisite in the shared prerequisite table
+    uint32_t prereqCount;
+};
+
+// MurmurHash3 64-bit finalizer: every input bit affects every output bit
+constexpr uint64_t embeddedMix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// FNV-1a over the ID, then mixed (IDs differ mostly in their last digits,
+// which plain FNV leaves out of the high bits). Shared by the generator and
+// lookups, so it must not change without regenerating every embedded catalog.
+constexpr uint64_t embeddedKeyHash(std::string_view key) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return embeddedMix(h);
+}
+
+// Scales a 32-bit hash onto [0, range) without a division
+constexpr uint32_t embeddedReduce(uint32_t hash, uint32_t range) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(hash) * range) >> 32);
+}
+
+constexpr uint32_t embeddedBucket(uint64_t keyHash, uint32_t bucketCount) {
+    return embeddedReduce(static_cast<uint32_t>(keyHash >> 32), bucketCount);
+}
+
+// Slot of a key hash under a bucket's seed
+constexpr uint32_t embeddedSlot(uint64_t keyHash, uint32_t seed, uint32_t slotCount) {
+    uint64_t h = embeddedMix(keyHash ^ (static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ull));
+    return embeddedReduce(static_cast<uint32_t>(h), slotCount);
+}
+
+class EmbeddedCatalog {
+private:
+    std::span<const EmbeddedCourse> courses;    // Sorted by ID
+    std::span<const std::string_view> prereqs;
+    std::span<const uint32_t> seeds;            // One per bucket
+    std::span<const uint32_t> slots;            // Slot -> index into courses
+
+public:
+    constexpr EmbeddedCatalog() = default;
+
+    constexpr EmbeddedCatalog(std::span<const EmbeddedCourse> aCourses, std::span<const std::string_view> aPrereqs,
+                              std::span<const uint32_t> aSeeds, std::span<const uint32_t> aSlots)
+        : courses(aCourses), prereqs(aPrereqs), seeds(aSeeds), slots(aSlots) {}
+
+    // The course with exactly this ID, or nullptr; one hash and one comparison
+    constexpr const EmbeddedCourse* Find(std::string_view courseId) const {
+        if (courses.empty()) return nullptr;
+        uint64_t h = embeddedKeyHash(courseId);
+        uint32_t seed = seeds[embeddedBucket(h, static_cast<uint32_t>(seeds.size()))];
+        const EmbeddedCourse& c = courses[slots[embeddedSlot(h, seed, static_cast<uint32_t>(slots.size()))]];
+        return c.id == courseId ? &c : nullptr;
+    }
+
+    constexpr std::span<const std::string_view> Prerequisites(const EmbeddedCourse& c) const {
+        return prereqs.subspan(c.firstPrereq, c.prereqCount);
+    }
+
+    // Every course in ID order
+    constexpr std::span<const EmbeddedCourse> Courses() const { return courses; }
+
+    // Courses whose ID starts with prefix, in ID order
+    constexpr std::span<const EmbeddedCourse> WithPrefix(std::string_view prefix) const {
+        auto first = std::lower_bound(courses.begin(), courses.end(), prefix,
+            [](const EmbeddedCourse& c, std::string_view key) { return c.id < key; });
+        auto last = std::partition_point(first, courses.end(),
+            [prefix](const EmbeddedCourse& c) { return c.id.starts_with(prefix); });
+        return courses.subspan(static_cast<size_t>(first - courses.begin()), static_cast<size_t>(last - first));
+    }
+
+    constexpr size_t Size() const { return courses.size(); }
+};
@@ -0,0 +1,50 @@
+//============================================================================
+// Name        : EmbeddedCourses.h
+// Description : Generated by CatalogEmbedGen from courses.csv; do not edit.
+//               9 courses, 3 perfect-hash buckets.
+//============================================================================
+
+#pragma once
+
+#include "EmbeddedCatalog.h"
+
+using namespace std::string_view_literals;
+
+inline constexpr std::string_view EMBEDDED_SOURCE = "courses.csv"sv;
+
+inline constexpr EmbeddedCourse EMBEDDED_COURSES[] = {
+    { "CSCI100"sv, "Introduction to Computer Science"sv, 0, 0 },
+    { "CSCI101"sv, "Introduction to Programming in C++"sv, 0, 1 },
+    { "CSCI200"sv, "Data Structures"sv, 1, 1 },
+    { "CSCI300"sv, "Introduction to Algorithms"sv, 2, 2 },
+    { "CSCI301"sv, "Advanced Programming in C++"sv, 4, 1 },
+    { "CSCI350"sv, "Operating Systems"sv, 5, 1 },
+    { "CSCI400"sv, "Large Software Development"sv, 6, 2 },
+    { "MATH201"sv, "Discrete Mathematics"sv, 8, 0 },
+    { "MATH350"sv, "Linear Algebra"sv, 8, 1 },
+};
+
+inline constexpr std::string_view EMBEDDED_PREREQS[] = {
+    "CSCI100"sv,
+    "CSCI101"sv,
+    "CSCI200"sv,
+    "MATH201"sv,
+    "CSCI101"sv,
+    "CSCI300"sv,
+    "CSCI301"sv,
+    "CSCI350"sv,
+    "MATH201"sv,
+};
+
+inline constexpr uint32_t EMBEDDED_SEEDS[] = {
+    61, 6, 4,
+};
+
+inline constexpr uint32_t EMBEDDED_SLOTS[] = {
+    3, 2, 5, 7, 1, 8, 0, 6, 4,
+};
+
+inline constexpr EmbeddedCatalog EMBEDDED_CATALOG(EMBEDDED_COURSES, EMBEDDED_PREREQS, EMBEDDED_SEEDS, EMBEDDED_SLOTS);
+
+static_assert(EMBEDDED_CATALOG.Find("CSCI100"sv) == &EMBEDDED_COURSES[0]);
+static_assert(EMBEDDED_CATALOG.Find("MATH350"sv) == &EMBEDDED_COURSES[8]);
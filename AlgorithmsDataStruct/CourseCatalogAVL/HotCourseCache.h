@@ -0,0 +1,247 @@
+//============================================================================
+// Name        : HotCourseCache.h
+// Author      : Sonny Coutu
+// Description : Small concurrent cache of pre-rendered course records for
+//               skewed lookup traffic. Keys are course IDs compared without
+//               regard to ASCII case, so "csci101" hits the entry for
+//               "CSCI101" without converting the query first. Each shard
+//               evicts with CLOCK, and a TinyLFU frequency sketch decides
+//               admission: a new key only replaces the CLOCK victim if it
+//               has been asked for more often recently, so a burst of
+//               one-off lookups cannot flush the popular courses.
+//============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class HotCourseCache {
+public:
+    using Value = std::shared_ptr<const std::string>;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t admitted = 0;
+        size_t rejected = 0;        // Turned away by the frequency filter
+        size_t invalidations = 0;
+    };
+
+private:
+    static const size_t SHARDS = 16;    // Independent locks, picked by key hash
+    static const int SKETCH_ROWS = 4;
+
+    struct Slot {
+        std::string key;
+        uint64_t hash = 0;
+        Value value;
+        bool referenced = false;
+        bool used = false;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex lock;
+        std::vector<Slot> slots;
+        std::unordered_map<uint64_t, size_t> byHash;    // Key hash -> slot
+        std::vector<size_t> freeSlots;
+        size_t hand = 0;
+        uint64_t generation = 0;    // Bumped by every invalidation
+        std::vector<uint8_t> sketch; // SKETCH_ROWS rows of saturating counters
+        size_t sketchMask = 0;
+        size_t increments = 0;      // Since the last halving
+        size_t sampleSize = 0;      // Halve every counter after this many increments
+        Stats stats;
+    };
+
+    Shard shards[SHARDS];
+    size_t capacity = 0;
+
+    // ASCII upper case, matching what the catalog does to IDs before a lookup
+    static unsigned char fold(unsigned char c) { return c >= 'a' && c <= 'z' ? static_cast<unsigned char>(c - 'a' + 'A') : c; }
+
+    // FNV-1a over the upper-cased bytes, then a MurmurHash3 finalizer
+    static uint64_t hashKey(std::string_view key) {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : key) {
+            h ^= fold(c);
+            h *= 1099511628211ull;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static bool sameKey(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (fold(static_cast<unsigned char>(a[i])) != fold(static_cast<unsigned char>(b[i]))) return false;
+        }
+        return true;
+    }
+
+    Shard& shardFor(uint64_t h) { return shards[(h >> 56) % SHARDS]; }
+
+    static size_t sketchIndex(const Shard& shard, uint64_t h, int row) {
+        uint64_t step = (h >> 32) | 1;
+        return row * (shard.sketchMask + 1) + ((h + row * step) & shard.sketchMask);
+    }
+
+    // Counts one request for h; every counter is halved once enough requests
+    // have been counted, so popularity fades when traffic moves on
+    static void recordRequest(Shard& shard, uint64_t h) {
+        if (shard.sketch.empty()) return;
+        for (int row = 0; row < SKETCH_ROWS; ++row) {
+            uint8_t& counter = shard.sketch[sketchIndex(shard, h, row)];
+            if (counter < 15) ++counter;
+        }
+        if (++shard.increments >= shard.sampleSize) {
+            for (uint8_t& counter : shard.sketch) counter >>= 1;
+            shard.increments /= 2;
+        }
+    }
+
+    static uint8_t frequency(const Shard& shard, uint64_t h) {
+        uint8_t estimate = 15;
+        for (int row = 0; row < SKETCH_ROWS; ++row) estimate = std::min(estimate, shard.sketch[sketchIndex(shard, h, row)]);
+        return estimate;
+    }
+
+    // CLOCK: the first slot not referenced since the hand last passed it
+    static size_t clockVictim(Shard& shard) {
+        for (;;) {
+            Slot& slot = shard.slots[shard.hand];
+            size_t index = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.slots.size();
+            if (!slot.referenced) return index;
+            slot.referenced = false;
+        }
+    }
+
+    static void release(Shard& shard, size_t index) {
+        Slot& slot = shard.slots[index];
+        shard.byHash.erase(slot.hash);
+        slot = Slot();
+        shard.freeSlots.push_back(index);
+    }
+
+public:
+    // Empties the cache and sizes it for about totalEntries records; 0 disables it
+    void Reset(size_t totalEntries) {
+        capacity = totalEntries;
+        size_t perShard = totalEntries ? (totalEntries + SHARDS - 1) / SHARDS : 0;
+        size_t width = 16;
+        while (width < perShard * 4) width *= 2;
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            shard.slots.assign(perShard, Slot());
+            shard.byHash.clear();
+            shard.freeSlots.clear();
+            for (size_t i = perShard; i-- > 0;) shard.freeSlots.push_back(i);
+            shard.hand = 0;
+            ++shard.generation;
+            shard.sketch.assign(perShard ? width * SKETCH_ROWS : 0, 0);
+            shard.sketchMask = width - 1;
+            shard.increments = 0;
+            shard.sampleSize = perShard * 10;
+            shard.stats = Stats();
+        }
+    }
+
+    bool Enabled() const { return capacity > 0; }
+    size_t Capacity() const { return capacity; }
+
+    // The cached value for key, or nullptr. On a miss, stamp receives the
+    // value Put needs to detect an invalidation made while the caller was
+    // computing the value from the catalog.
+    Value Get(std::string_view key, uint64_t& stamp) {
+        uint64_t h = hashKey(key);
+        Shard& shard = shardFor(h);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        recordRequest(shard, h);
+        auto it = shard.byHash.find(h);
+        if (it != shard.byHash.end() && sameKey(shard.slots[it->second].key, key)) {
+            Slot& slot = shard.slots[it->second];
+            slot.referenced = true;
+            ++shard.stats.hits;
+            return slot.value;
+        }
+        ++shard.stats.misses;
+        stamp = shard.generation;
+        return nullptr;
+    }
+
+    // Offers a value computed after a Get miss. When the shard is full it is
+    // admitted only if key is requested more often than the CLOCK victim.
+    void Put(std::string_view key, Value value, uint64_t stamp) {
+        uint64_t h = hashKey(key);
+        Shard& shard = shardFor(h);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.slots.empty() || stamp != shard.generation) return; // invalidated meanwhile
+        auto it = shard.byHash.find(h);
+        if (it != shard.byHash.end()) release(shard, it->second); // same key, or a hash collision
+        if (shard.freeSlots.empty()) {
+            size_t victim = clockVictim(shard);
+            if (frequency(shard, h) <= frequency(shard, shard.slots[victim].hash)) {
+                ++shard.stats.rejected;
+                return;
+            }
+            release(shard, victim);
+        }
+        size_t index = shard.freeSlots.back();
+        shard.freeSlots.pop_back();
+        Slot& slot = shard.slots[index];
+        slot.key.assign(key.begin(), key.end());
+        slot.hash = h;
+        slot.value = std::move(value);
+        slot.referenced = false; // earns its second chance with its first hit
+        slot.used = true;
+        shard.byHash[h] = index;
+        ++shard.stats.admitted;
+    }
+
+    // Drops the entry for key (in any case) and voids pending Puts for its shard
+    void Invalidate(std::string_view key) {
+        uint64_t h = hashKey(key);
+        Shard& shard = shardFor(h);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        ++shard.generation;
+        ++shard.stats.invalidations;
+        auto it = shard.byHash.find(h);
+        if (it != shard.byHash.end()) release(shard, it->second);
+    }
+
+    // Drops every entry; request frequencies are kept
+    void Clear() {
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            ++shard.generation;
+            ++shard.stats.invalidations;
+            for (size_t i = 0; i < shard.slots.size(); ++i) {
+                if (shard.slots[i].used) release(shard, i);
+            }
+        }
+    }
+
+    Stats GetStats() {
+        Stats total;
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            total.hits += shard.stats.hits;
+            total.misses += shard.stats.misses;
+            total.admitted += shard.stats.admitted;
+            total.rejected += shard.stats.rejected;
+            total.invalidations += shard.stats.invalidations;
+        }
+        return total;
+    }
+};
@@ -0,0 +1,206 @@
+//============================================================================
+// Name        : IndexShootout.cpp
+// Author      : Sonny Coutu
+// Description : Benchmark that runs identical catalog workloads against every
+//               ordered-index backend in OrderedIndex.h, after checking that
+//               the catalog's hot lookup paths allocate nothing.
+//               Usage: IndexShootout [courseCount] [courses.csv]
+//============================================================================
+
+#define CATALOG_ALLOCATION_HOOK // count every allocation (MemoryReport.h)
+
+#include "DiskCatalog.h"
+#include "MemoryReport.h"
+#include "OrderedIndex.h"
+#include "ShardedCatalog.h"
+
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+
+// One generated workload shared by every backend
+struct Workload {
+    vector<Course> sortedCourses;   // Ascending IDs, as the catalog CSV is laid out
+    vector<Course> shuffledCourses; // Same courses in random order
+    vector<string> hitKeys;         // Present IDs in random order
+    vector<string> missKeys;        // Absent IDs (valid format, not in the catalog)
+    vector<string> deleteKeys;      // Half of the present IDs in random order
+    string csvPath;                 // Optional real catalog to load
+};
+
+// Builds "DEPT000123"-style IDs across a handful of departments
+Workload makeWorkload(int courseCount, const string& csvPath) {
+    static const char* departments[] = { "ARTS", "BIOL", "CHEM", "CSCI", "ECON", "HIST", "MATH", "PHYS" };
+    Workload w;
+    w.csvPath = csvPath;
+    mt19937 rng(42);
+
+    for (int i = 0; i < courseCount; ++i) {
+        ostringstream id;
+        id << departments[i % 8] << setw(6) << setfill('0') << (i / 8) * 2; // even numbers present
+        Course c{ id.str(), "Course " + to_string(i), {} };
+        if (i >= 16) c.preReqs.push_back(w.shuffledCourses[rng() % w.shuffledCourses.size()].courseNumber);
+        w.shuffledCourses.push_back(c);
+    }
+    w.sortedCourses = w.shuffledCourses;
+    sort(w.sortedCourses.begin(), w.sortedCourses.end(),
+        [](const Course& a, const Course& b) { return a.courseNumber < b.courseNumber; });
+    shuffle(w.shuffledCourses.begin(), w.shuffledCourses.end(), rng);
+
+    for (const Course& c : w.shuffledCourses) {
+        w.hitKeys.push_back(c.courseNumber);
+        string miss = c.courseNumber;
+        miss.back() = static_cast<char>(miss.back() + 1); // odd numbers are never present
+        w.missKeys.push_back(miss);
+    }
+    w.deleteKeys.assign(w.hitKeys.begin(), w.hitKeys.begin() + w.hitKeys.size() / 2);
+    return w;
+}
+
+// Detects backends that offer the prefetching SearchBatch
+template <typename Index, typename = void>
+struct HasSearchBatch : false_type {};
+
+template <typename Index>
+struct HasSearchBatch<Index, void_t<decltype(declval<const Index&>().SearchBatch(
+    declval<span<const string_view>>(), declval<span<const Course*>>()))>> : true_type {};
+
+// Detects backends that load a whole CSV themselves (in parallel)
+template <typename Index, typename = void>
+struct HasBulkLoad : false_type {};
+
+template <typename Index>
+struct HasBulkLoad<Index, void_t<decltype(declval<Index&>().Load(declval<const string&>()))>> : true_type {};
+
+// AVL tree with its negative-lookup Bloom filter switched on
+struct FilteredAvl : BinarySearchTree {
+    FilteredAvl() { EnableMissFilter(true); }
+};
+
+// Disk B+-tree over a scratch page file with the default 1 MiB page cache
+struct ScratchDiskCatalog : DiskCatalog {
+    ScratchDiskCatalog() {
+        static int files = 0;
+        Create("IndexShootout." + to_string(files++) + ".pages");
+    }
+    ~ScratchDiskCatalog() {
+        Close();
+        remove(Path().c_str());
+    }
+};
+
+// Times fn() and returns elapsed milliseconds
+template <typename Fn>
+double timeMs(Fn fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void printRow(const string& backend, const string& phase, double ms, size_t ops) {
+    cout << left << setw(10) << backend << setw(16) << phase
+         << right << setw(12) << fixed << setprecision(2) << ms << " ms"
+         << setw(12) << setprecision(1) << (ops ? ms * 1e6 / ops : 0.0) << " ns/op" << endl;
+}
+
+// Runs every workload phase against a fresh instance of Index
+template <typename Index>
+void runBackend(const string& name, const Workload& w) {
+    static_assert(OrderedIndex<Index>, "backend does not provide the ordered-index operations");
+    size_t sink = 0; // Consumed by every phase so the optimizer cannot drop the work
+
+    {
+        Index index;
+        printRow(name, "insert-sorted", timeMs([&] { for (const Course& c : w.sortedCourses) index.Insert(c); }), w.sortedCourses.size());
+    }
+
+    Index index;
+    printRow(name, "insert-random", timeMs([&] { for (const Course& c : w.shuffledCourses) index.Insert(c); }), w.shuffledCourses.size());
+    printRow(name, "find-hit", timeMs([&] {
+        for (const string& key : w.hitKeys) sink += index.Find(key) != nullptr;
+    }), w.hitKeys.size());
+    if constexpr (HasSearchBatch<Index>::value) {
+        vector<string_view> keys(w.hitKeys.begin(), w.hitKeys.end());
+        vector<const Course*> results(keys.size());
+        printRow(name, "find-hit-batch", timeMs([&] {
+            index.SearchBatch(keys, results);
+            for (const Course* c : results) sink += c != nullptr;
+        }), keys.size());
+    }
+    printRow(name, "find-miss", timeMs([&] {
+        for (const string& key : w.missKeys) sink += index.Find(key) != nullptr;
+    }), w.missKeys.size());
+    printRow(name, "scan", timeMs([&] {
+        index.ForEach([&sink](const Course& c) { sink += c.courseName.size(); });
+    }), static_cast<size_t>(index.Size()));
+    printRow(name, "delete-half", timeMs([&] {
+        for (const string& key : w.deleteKeys) sink += index.Delete(key);
+    }), w.deleteKeys.size());
+
+    if (!w.csvPath.empty()) {
+        Index fromFile;
+        double ms = timeMs([&] { loadCourses(w.csvPath, &fromFile); }); // before Size() is read
+        printRow(name, "load-csv", ms, static_cast<size_t>(fromFile.Size()));
+        if constexpr (HasBulkLoad<Index>::value) {
+            Index bulk;
+            ms = timeMs([&] { bulk.Load(w.csvPath); });
+            printRow(name, "load-csv-bulk", ms, static_cast<size_t>(bulk.Size()));
+        }
+    }
+
+    if (sink == 0) cout << "(no work done)" << endl;
+}
+
+// Lookups that must not touch the heap: Find, hit or miss, and RenderCourse
+// once the course is in the hot cache. False (with a message) on any allocation.
+bool checkAllocationBudgets(const Workload& w) {
+    BinarySearchTree catalog;
+    for (const Course& c : w.sortedCourses) catalog.Insert(c);
+    catalog.EnableHotCache(64);
+    const string& hit = w.hitKeys.front();
+    const string& miss = w.missKeys.front();
+    catalog.RenderCourse(hit); // admitted to the empty cache
+    bool ok = true;
+    auto check = [&ok](const char* operation, AllocationCounters used, bool answered) {
+        if (answered && used.allocations == 0) return;
+        cout << "Allocation budget exceeded: " << operation << " made " << used.allocations
+             << " allocations (" << used.bytes << " bytes)" << (answered ? "" : " and returned the wrong result") << "." << endl;
+        ok = false;
+    };
+    {
+        AllocationScope scope;
+        bool answered = catalog.Find(hit) != nullptr;
+        check("Find (hit)", scope.Used(), answered);
+    }
+    {
+        AllocationScope scope;
+        bool answered = catalog.Find(miss) == nullptr;
+        check("Find (miss)", scope.Used(), answered);
+    }
+    {
+        AllocationScope scope;
+        bool answered = catalog.RenderCourse(hit) != nullptr;
+        AllocationCounters used = scope.Used(); // before HotCacheStats, which may allocate
+        check("RenderCourse (cached)", used, answered && catalog.HotCacheStats().hits == 1);
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+
+    int courseCount = argc > 1 ? atoi(argv[1]) : 200000;
+    if (courseCount <= 0) courseCount = 200000;
+    Workload w = makeWorkload(courseCount, argc > 2 ? argv[2] : "");
+    if (!checkAllocationBudgets(w)) return 1;
+
+    cout << "Ordered-index shootout: " << courseCount << " courses" << endl << endl;
+    runBackend<BinarySearchTree>("avl", w);
+    runBackend<FilteredAvl>("avl+bloom", w);
+    runBackend<ShardedCatalog>("sharded", w);
+    runBackend<RedBlackIndex>("red-black", w);
+    runBackend<BPlusTreeIndex>("b+tree", w);
+    runBackend<ScratchDiskCatalog>("disk", w);
+    runBackend<SkipListIndex>("skiplist", w);
+    runBackend<StdMapIndex>("std::map", w);
+    return 0;
+}
@@ -0,0 +1,190 @@
+//============================================================================
+// Name        : MemoryReport.h
+// Author      : Sonny Coutu
+// Description : Byte-level accounting of the catalog tree for host sizing:
+//               node overhead, strings held inline (small-string buffer)
+//               versus on the heap, prerequisite array capacity versus use,
+//               and allocator slack (reserved minus requested bytes).
+//               Also per-thread allocation counters; a program that defines
+//               CATALOG_ALLOCATION_HOOK before including this header (in one
+//               translation unit) routes every operator new through them, so
+//               AllocationScope can check an operation's allocation budget.
+//               The hook replaces the global allocator, so only benchmarks
+//               (IndexShootout) and /DCATALOG_ALLOCATION_HOOK builds use it.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#if defined(_MSC_VER) || defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+// Bytes the allocator actually reserved for a block requested at size bytes
+inline size_t allocatedSize(const void* block, size_t requested) {
+    (void)requested; // only needed where the allocator cannot be asked
+#if defined(_MSC_VER)
+    return _msize(const_cast<void*>(block));
+#elif defined(__GLIBC__)
+    return malloc_usable_size(const_cast<void*>(block));
+#elif defined(__APPLE__)
+    return malloc_size(block);
+#else
+    (void)block;
+    return requested; // slack reads as zero
+#endif
+}
+
+// Heap blocks of one kind: what was asked for and what the allocator reserved
+struct HeapTally {
+    size_t blocks = 0;
+    size_t requested = 0;
+    size_t reserved = 0;
+
+    void Add(const void* block, size_t size) {
+        ++blocks;
+        requested += size;
+        reserved += allocatedSize(block, size);
+    }
+
+    size_t Slack() const { return reserved - requested; }
+};
+
+// Strings of one field: how many fit inline and what the rest cost on the heap
+struct StringTally {
+    size_t strings = 0;
+    size_t inlineCount = 0;
+    size_t chars = 0;
+    HeapTally heap;
+
+    void Add(const string& s) {
+        ++strings;
+        chars += s.size();
+        if (stringOnHeap(s)) heap.Add(s.data(), s.capacity() + 1);
+        else ++inlineCount;
+    }
+};
+
+struct MemoryUsage {
+    size_t courses = 0;
+    size_t pending = 0;             // Courses from a lazy load not yet parsed
+    HeapTally nodes;                // Node blocks; each embeds its Course object
+    StringTally courseNumbers;
+    StringTally courseNames;
+    StringTally prereqIds;
+    HeapTally prereqArrays;         // preReqs element buffers
+    size_t prereqSlotsUsed = 0;     // Bytes of those buffers holding a string
+    size_t prereqSlotsSpare = 0;    // Bytes reserved by capacity but unused
+    size_t pendingIndexBytes = 0;   // Lazy-load row table (estimated)
+    size_t missFilterBytes = 0;
+
+    // Everything the catalog holds on the heap
+    size_t Total() const {
+        return nodes.reserved + courseNumbers.heap.reserved + courseNames.heap.reserved
+             + prereqIds.heap.reserved + prereqArrays.reserved + pendingIndexBytes + missFilterBytes;
+    }
+};
+
+// Walks every node of the tree; pending courses are counted as they stand
+inline MemoryUsage measureCatalog(const BinarySearchTree& catalog) {
+    MemoryUsage usage;
+    catalog.ForEachNodeBlock([&usage](const void* block, size_t blockSize, const Course& c) {
+        ++usage.courses;
+        usage.nodes.Add(block, blockSize);
+        usage.courseNumbers.Add(c.courseNumber);
+        usage.courseNames.Add(c.courseName);
+        if (c.preReqs.capacity() > 0) {
+            usage.prereqArrays.Add(c.preReqs.data(), c.preReqs.capacity() * sizeof(string));
+            usage.prereqSlotsUsed += c.preReqs.size() * sizeof(string);
+            usage.prereqSlotsSpare += (c.preReqs.capacity() - c.preReqs.size()) * sizeof(string);
+        }
+        for (const string& pre : c.preReqs) usage.prereqIds.Add(pre);
+    });
+    usage.pending = catalog.PendingCount();
+    usage.pendingIndexBytes = catalog.PendingIndexBytes();
+    usage.missFilterBytes = catalog.MissFilterBytes();
+    return usage;
+}
+
+// ---------------- Allocation counting ----------------
+
+struct AllocationCounters {
+    size_t allocations = 0;
+    size_t bytes = 0;
+    size_t frees = 0;
+};
+
+// This thread's running totals; they stay zero without CATALOG_ALLOCATION_HOOK
+inline thread_local AllocationCounters threadAllocations;
+
+#ifdef CATALOG_ALLOCATION_HOOK
+inline constexpr bool ALLOCATIONS_COUNTED = true;
+#else
+inline constexpr bool ALLOCATIONS_COUNTED = false;
+#endif
+
+// Allocations made by this thread since construction, e.g.
+//   AllocationScope scope; catalog.Find(id); assert(scope.Allocations() == 0);
+class AllocationScope {
+private:
+    AllocationCounters start = threadAllocations;
+
+public:
+    size_t Allocations() const { return threadAllocations.allocations - start.allocations; }
+    size_t Bytes() const { return threadAllocations.bytes - start.bytes; }
+    size_t Frees() const { return threadAllocations.frees - start.frees; }
+    AllocationCounters Used() const { return { Allocations(), Bytes(), Frees() }; }
+};
+
+#ifdef CATALOG_ALLOCATION_HOOK
+// Replacement global allocation functions; the nothrow forms call these
+
+inline void* countedAllocate(size_t size, size_t alignment) {
+    ++threadAllocations.allocations;
+    threadAllocations.bytes += size;
+    if (size == 0) size = 1;
+    for (;;) {
+#ifdef _MSC_VER
+        void* block = alignment ? _aligned_malloc(size, alignment) : malloc(size);
+#else
+        void* block = alignment ? aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : malloc(size);
+#endif
+        if (block) return block;
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+}
+
+inline void countedFree(void* block, bool aligned) noexcept {
+    if (!block) return;
+    ++threadAllocations.frees;
+#ifdef _MSC_VER
+    if (aligned) _aligned_free(block);
+    else free(block);
+#else
+    (void)aligned;
+    free(block);
+#endif
+}
+
+void* operator new(size_t size) { return countedAllocate(size, 0); }
+void* operator new[](size_t size) { return countedAllocate(size, 0); }
+void* operator new(size_t size, align_val_t alignment) { return countedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, align_val_t alignment) { return countedAllocate(size, static_cast<size_t>(alignment)); }
+void operator delete(void* block) noexcept { countedFree(block, false); }
+void operator delete[](void* block) noexcept { countedFree(block, false); }
+void operator delete(void* block, size_t) noexcept { countedFree(block, false); }
+void operator delete[](void* block, size_t) noexcept { countedFree(block, false); }
+void operator delete(void* block, align_val_t) noexcept { countedFree(block, true); }
+void operator delete[](void* block, align_val_t) noexcept { countedFree(block, true); }
+void operator delete(void* block, size_t, align_val_t) noexcept { countedFree(block, true); }
+void operator delete[](void* block, size_t, align_val_t) noexcept { countedFree(block, true); }
+#endif
@@ -0,0 +1,539 @@
+//============================================================================
+// Name        : OrderedIndex.h
+// Author      : Sonny Coutu
+// Description : Interchangeable ordered-index backends for the catalog.
+//               Any type with the operations below can hold the catalog
+//               (loadCourses, exportCatalog, IndexShootout, and the
+//               --lookup mode, which takes the backend by name):
+//                 void Insert(const Course&)          no duplicate IDs
+//                 bool Delete(const string&)          true if removed
+//                 const Course* Find(const string&) const
+//                 void ForEach(Visitor) const         key order
+//                 int Size()
+//               BinarySearchTree (AVL) already satisfies it; this file adds
+//               red-black, B+-tree, skip list and std::map backends. The
+//               interactive menu stays on the AVL tree, which alone has the
+//               journal, lazy loading and content hashes it relies on.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <concepts>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+// Compile-time check that Index provides the ordered-index operations. ForEach
+// is checked with a plain function, since any Visitor must be accepted.
+template <typename Index>
+concept OrderedIndex = requires(Index& index, const Index& view, const Course& course, const string& courseNumber,
+                                void (*visit)(const Course&)) {
+    index.Insert(course);
+    { index.Delete(courseNumber) } -> convertible_to<bool>;
+    { view.Find(courseNumber) } -> convertible_to<const Course*>;
+    view.ForEach(visit);
+    { index.Size() } -> convertible_to<int>;
+};
+
+template <typename Index>
+struct IsOrderedIndex : bool_constant<OrderedIndex<Index>> {};
+
+
+// ======================== std::map baseline ========================
+class StdMapIndex {
+private:
+    map<string, Course> courses;
+
+public:
+    void Insert(const Course& aCourse) { courses.emplace(aCourse.courseNumber, aCourse); }
+
+    bool Delete(const string& courseNumber) { return courses.erase(courseNumber) > 0; }
+
+    const Course* Find(const string& courseNumber) const {
+        auto it = courses.find(courseNumber);
+        return it == courses.end() ? nullptr : &it->second;
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        for (const auto& entry : courses) visit(entry.second);
+    }
+
+    int Size() const { return static_cast<int>(courses.size()); }
+};
+
+
+// ======================== Left-leaning red-black tree ========================
+// Sedgewick's LLRB: a red-black tree in which red links lean left, so insert
+// and delete reduce to three local fix-ups (rotate left, rotate right, flip).
+class RedBlackIndex {
+private:
+    struct Node {
+        Course course;
+        Node* left;
+        Node* right;
+        bool red;       // Color of the link from the parent
+
+        Node(const Course& c) : course(c), left(nullptr), right(nullptr), red(true) {}
+    };
+
+    Node* root;
+    int size;
+
+    static bool isRed(Node* n) { return n && n->red; }
+
+    static Node* rotateLeft(Node* h) {
+        Node* x = h->right;
+        h->right = x->left;
+        x->left = h;
+        x->red = h->red;
+        h->red = true;
+        return x;
+    }
+
+    static Node* rotateRight(Node* h) {
+        Node* x = h->left;
+        h->left = x->right;
+        x->right = h;
+        x->red = h->red;
+        h->red = true;
+        return x;
+    }
+
+    static void flipColors(Node* h) {
+        h->red = !h->red;
+        h->left->red = !h->left->red;
+        h->right->red = !h->right->red;
+    }
+
+    // Restores the left-leaning invariants on the way back up
+    static Node* fixUp(Node* h) {
+        if (isRed(h->right) && !isRed(h->left)) h = rotateLeft(h);
+        if (isRed(h->left) && isRed(h->left->left)) h = rotateRight(h);
+        if (isRed(h->left) && isRed(h->right)) flipColors(h);
+        return h;
+    }
+
+    static Node* insertRec(Node* h, const Course& c, bool& inserted) {
+        if (!h) {
+            inserted = true;
+            return new Node(c);
+        }
+        if (c.courseNumber < h->course.courseNumber) h->left = insertRec(h->left, c, inserted);
+        else if (c.courseNumber > h->course.courseNumber) h->right = insertRec(h->right, c, inserted);
+        else inserted = false; // No duplicates allowed
+        return fixUp(h);
+    }
+
+    // Borrow a red link so the left child is not a 2-node
+    static Node* moveRedLeft(Node* h) {
+        flipColors(h);
+        if (isRed(h->right->left)) {
+            h->right = rotateRight(h->right);
+            h = rotateLeft(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    // Borrow a red link so the right child is not a 2-node
+    static Node* moveRedRight(Node* h) {
+        flipColors(h);
+        if (isRed(h->left->left)) {
+            h = rotateRight(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    static Node* deleteMin(Node* h) {
+        if (!h->left) {
+            delete h;
+            return nullptr;
+        }
+        if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+        h->left = deleteMin(h->left);
+        return fixUp(h);
+    }
+
+    // Key must be present (checked by Delete)
+    static Node* deleteRec(Node* h, const string& courseNumber) {
+        if (courseNumber < h->course.courseNumber) {
+            if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+            h->left = deleteRec(h->left, courseNumber);
+        }
+        else {
+            if (isRed(h->left)) h = rotateRight(h);
+            if (courseNumber == h->course.courseNumber && !h->right) {
+                delete h;
+                return nullptr;
+            }
+            if (!isRed(h->right) && !isRed(h->right->left)) h = moveRedRight(h);
+            if (courseNumber == h->course.courseNumber) {
+                Node* successor = h->right;
+                while (successor->left) successor = successor->left;
+                h->course = move(successor->course);
+                h->right = deleteMin(h->right);
+            }
+            else h->right = deleteRec(h->right, courseNumber);
+        }
+        return fixUp(h);
+    }
+
+    template <typename Visitor>
+    static void forEachRec(const Node* node, Visitor& visit) {
+        if (!node) return;
+        forEachRec(node->left, visit);
+        visit(node->course);
+        forEachRec(node->right, visit);
+    }
+
+    static void deleteSubtree(Node* node) {
+        if (!node) return;
+        deleteSubtree(node->left);
+        deleteSubtree(node->right);
+        delete node;
+    }
+
+public:
+    RedBlackIndex() : root(nullptr), size(0) {}
+    ~RedBlackIndex() { deleteSubtree(root); }
+    RedBlackIndex(const RedBlackIndex&) = delete;
+    RedBlackIndex& operator=(const RedBlackIndex&) = delete;
+
+    void Insert(const Course& aCourse) {
+        bool inserted = false;
+        root = insertRec(root, aCourse, inserted);
+        root->red = false;
+        if (inserted) ++size;
+    }
+
+    bool Delete(const string& courseNumber) {
+        if (!Find(courseNumber)) return false;
+        if (!isRed(root->left) && !isRed(root->right)) root->red = true;
+        root = deleteRec(root, courseNumber);
+        if (root) root->red = false;
+        --size;
+        return true;
+    }
+
+    const Course* Find(const string& courseNumber) const {
+        const Node* node = root;
+        while (node) {
+            if (courseNumber == node->course.courseNumber) return &node->course;
+            node = courseNumber < node->course.courseNumber ? node->left : node->right;
+        }
+        return nullptr;
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visit) const { forEachRec(root, visit); }
+
+    int Size() const { return size; }
+};
+
+
+// ======================== In-memory B+-tree ========================
+// Wide nodes keep the keys of one node contiguous, so a lookup touches
+// about log_32(n) nodes instead of log_2(n). Courses live only in the
+// leaves, which are chained for ordered scans.
+class BPlusTreeIndex {
+private:
+    static const int MAX_KEYS = 64;             // Split when a node exceeds this
+    static const int MIN_KEYS = MAX_KEYS / 2;   // Rebalance when a node drops below this
+
+    struct Node {
+        bool leaf;
+        vector<string> keys;        // Leaf: course IDs; internal: separators
+        vector<Node*> children;     // Internal only: keys.size() + 1 entries
+        vector<Course> courses;     // Leaf only: parallel to keys
+        Node* next;                 // Leaf only: next leaf in key order
+
+        Node(bool isLeaf) : leaf(isLeaf), next(nullptr) {}
+    };
+
+    Node* root;
+    int size;
+
+    // Child slot to descend into for a key (separator i is the smallest key of child i + 1)
+    static size_t childIndex(const Node* node, const string& key) {
+        return upper_bound(node->keys.begin(), node->keys.end(), key) - node->keys.begin();
+    }
+
+    // Inserts into the subtree; on overflow returns the new right sibling and its separator
+    Node* insertRec(Node* node, const Course& c, bool& inserted, string& separator) {
+        if (node->leaf) {
+            auto pos = lower_bound(node->keys.begin(), node->keys.end(), c.courseNumber);
+            if (pos != node->keys.end() && *pos == c.courseNumber) {
+                inserted = false; // No duplicates allowed
+                return nullptr;
+            }
+            size_t i = pos - node->keys.begin();
+            node->keys.insert(pos, c.courseNumber);
+            node->courses.insert(node->courses.begin() + i, c);
+            inserted = true;
+            if (static_cast<int>(node->keys.size()) <= MAX_KEYS) return nullptr;
+
+            size_t mid = node->keys.size() / 2;
+            Node* right = new Node(true);
+            right->keys.assign(node->keys.begin() + mid, node->keys.end());
+            right->courses.assign(make_move_iterator(node->courses.begin() + mid), make_move_iterator(node->courses.end()));
+            node->keys.resize(mid);
+            node->courses.resize(mid);
+            right->next = node->next;
+            node->next = right;
+            separator = right->keys.front();
+            return right;
+        }
+
+        size_t i = childIndex(node, c.courseNumber);
+        string childSeparator;
+        Node* split = insertRec(node->children[i], c, inserted, childSeparator);
+        if (!split) return nullptr;
+        node->keys.insert(node->keys.begin() + i, childSeparator);
+        node->children.insert(node->children.begin() + i + 1, split);
+        if (static_cast<int>(node->keys.size()) <= MAX_KEYS) return nullptr;
+
+        size_t mid = node->keys.size() / 2;
+        Node* right = new Node(false);
+        separator = node->keys[mid];
+        right->keys.assign(node->keys.begin() + mid + 1, node->keys.end());
+        right->children.assign(node->children.begin() + mid + 1, node->children.end());
+        node->keys.resize(mid);
+        node->children.resize(mid + 1);
+        return right;
+    }
+
+    // Refills child i of parent after it dropped below MIN_KEYS
+    static void rebalanceChild(Node* parent, size_t i) {
+        Node* child = parent->children[i];
+        Node* left = i > 0 ? parent->children[i - 1] : nullptr;
+        Node* right = i + 1 < parent->children.size() ? parent->children[i + 1] : nullptr;
+
+        if (left && static_cast<int>(left->keys.size()) > MIN_KEYS) { // borrow from left sibling
+            if (child->leaf) {
+                child->keys.insert(child->keys.begin(), move(left->keys.back()));
+                child->courses.insert(child->courses.begin(), move(left->courses.back()));
+                left->keys.pop_back();
+                left->courses.pop_back();
+                parent->keys[i - 1] = child->keys.front();
+            }
+            else {
+                child->keys.insert(child->keys.begin(), move(parent->keys[i - 1]));
+                child->children.insert(child->children.begin(), left->children.back());
+                parent->keys[i - 1] = move(left->keys.back());
+                left->keys.pop_back();
+                left->children.pop_back();
+            }
+            return;
+        }
+        if (right && static_cast<int>(right->keys.size()) > MIN_KEYS) { // borrow from right sibling
+            if (child->leaf) {
+                child->keys.push_back(move(right->keys.front()));
+                child->courses.push_back(move(right->courses.front()));
+                right->keys.erase(right->keys.begin());
+                right->courses.erase(right->courses.begin());
+                parent->keys[i] = right->keys.front();
+            }
+            else {
+                child->keys.push_back(move(parent->keys[i]));
+                child->children.push_back(right->children.front());
+                parent->keys[i] = move(right->keys.front());
+                right->keys.erase(right->keys.begin());
+                right->children.erase(right->children.begin());
+            }
+            return;
+        }
+        // Both siblings are minimal: merge with one of them
+        if (left) mergeChildren(parent, i - 1);
+        else if (right) mergeChildren(parent, i);
+    }
+
+    // Folds child i + 1 of parent into child i
+    static void mergeChildren(Node* parent, size_t i) {
+        Node* left = parent->children[i];
+        Node* right = parent->children[i + 1];
+        if (left->leaf) {
+            left->keys.insert(left->keys.end(), make_move_iterator(right->keys.begin()), make_move_iterator(right->keys.end()));
+            left->courses.insert(left->courses.end(), make_move_iterator(right->courses.begin()), make_move_iterator(right->courses.end()));
+            left->next = right->next;
+        }
+        else {
+            left->keys.push_back(move(parent->keys[i]));
+            left->keys.insert(left->keys.end(), make_move_iterator(right->keys.begin()), make_move_iterator(right->keys.end()));
+            left->children.insert(left->children.end(), right->children.begin(), right->children.end());
+        }
+        parent->keys.erase(parent->keys.begin() + i);
+        parent->children.erase(parent->children.begin() + i + 1);
+        delete right;
+    }
+
+    bool deleteRec(Node* node, const string& courseNumber) {
+        if (node->leaf) {
+            auto pos = lower_bound(node->keys.begin(), node->keys.end(), courseNumber);
+            if (pos == node->keys.end() || *pos != courseNumber) return false;
+            node->courses.erase(node->courses.begin() + (pos - node->keys.begin()));
+            node->keys.erase(pos);
+            return true;
+        }
+        size_t i = childIndex(node, courseNumber);
+        if (!deleteRec(node->children[i], courseNumber)) return false;
+        if (static_cast<int>(node->children[i]->keys.size()) < MIN_KEYS) rebalanceChild(node, i);
+        return true;
+    }
+
+    static void deleteSubtree(Node* node) {
+        if (!node->leaf) {
+            for (Node* child : node->children) deleteSubtree(child);
+        }
+        delete node;
+    }
+
+public:
+    BPlusTreeIndex() : root(new Node(true)), size(0) {}
+    ~BPlusTreeIndex() { deleteSubtree(root); }
+    BPlusTreeIndex(const BPlusTreeIndex&) = delete;
+    BPlusTreeIndex& operator=(const BPlusTreeIndex&) = delete;
+
+    void Insert(const Course& aCourse) {
+        bool inserted = false;
+        string separator;
+        Node* split = insertRec(root, aCourse, inserted, separator);
+        if (split) { // grow a new root
+            Node* newRoot = new Node(false);
+            newRoot->keys.push_back(separator);
+            newRoot->children.push_back(root);
+            newRoot->children.push_back(split);
+            root = newRoot;
+        }
+        if (inserted) ++size;
+    }
+
+    bool Delete(const string& courseNumber) {
+        if (!deleteRec(root, courseNumber)) return false;
+        if (!root->leaf && root->keys.empty()) { // shrink an empty root
+            Node* oldRoot = root;
+            root = root->children.front();
+            delete oldRoot;
+        }
+        --size;
+        return true;
+    }
+
+    const Course* Find(const string& courseNumber) const {
+        const Node* node = root;
+        while (!node->leaf) node = node->children[childIndex(node, courseNumber)];
+        auto pos = lower_bound(node->keys.begin(), node->keys.end(), courseNumber);
+        if (pos == node->keys.end() || *pos != courseNumber) return nullptr;
+        return &node->courses[pos - node->keys.begin()];
+    }
+
+    // Walks the leaf chain from the leftmost leaf
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        const Node* node = root;
+        while (!node->leaf) node = node->children.front();
+        for (; node; node = node->next) {
+            for (const Course& c : node->courses) visit(c);
+        }
+    }
+
+    int Size() const { return size; }
+};
+
+
+// ======================== Skip list ========================
+// Probabilistic ordered list with express lanes; p = 1/4 gives an expected
+// 1.33 forward pointers per course and O(log n) expected search.
+class SkipListIndex {
+private:
+    static const int MAX_LEVEL = 24; // Enough for 4^24 courses
+
+    struct Node {
+        Course course;
+        int level;
+        Node** next;    // next[0..level) forward pointers
+
+        Node(const Course& c, int lvl) : course(c), level(lvl), next(new Node*[lvl]()) {}
+        ~Node() { delete[] next; }
+    };
+
+    Node head;      // Sentinel with MAX_LEVEL forward pointers
+    int level;      // Highest level currently in use
+    int size;
+    minstd_rand rng;
+
+    int randomLevel() {
+        int lvl = 1;
+        while (lvl < MAX_LEVEL && (rng() & 3) == 0) ++lvl;
+        return lvl;
+    }
+
+    // Fills update[i] with the last node at level i whose key is < courseNumber
+    Node* findPredecessors(const string& courseNumber, Node** update) {
+        Node* x = &head;
+        for (int i = level - 1; i >= 0; --i) {
+            while (x->next[i] && x->next[i]->course.courseNumber < courseNumber) x = x->next[i];
+            update[i] = x;
+        }
+        return x->next[0];
+    }
+
+public:
+    SkipListIndex() : head(Course{}, MAX_LEVEL), level(1), size(0), rng(20240401) {}
+    ~SkipListIndex() {
+        Node* x = head.next[0];
+        while (x) {
+            Node* next = x->next[0];
+            delete x;
+            x = next;
+        }
+    }
+    SkipListIndex(const SkipListIndex&) = delete;
+    SkipListIndex& operator=(const SkipListIndex&) = delete;
+
+    void Insert(const Course& aCourse) {
+        Node* update[MAX_LEVEL];
+        Node* x = findPredecessors(aCourse.courseNumber, update);
+        if (x && x->course.courseNumber == aCourse.courseNumber) return; // No duplicates allowed
+
+        int lvl = randomLevel();
+        for (int i = level; i < lvl; ++i) update[i] = &head;
+        level = max(level, lvl);
+        Node* node = new Node(aCourse, lvl);
+        for (int i = 0; i < lvl; ++i) {
+            node->next[i] = update[i]->next[i];
+            update[i]->next[i] = node;
+        }
+        ++size;
+    }
+
+    bool Delete(const string& courseNumber) {
+        Node* update[MAX_LEVEL];
+        Node* x = findPredecessors(courseNumber, update);
+        if (!x || x->course.courseNumber != courseNumber) return false;
+        for (int i = 0; i < x->level; ++i) update[i]->next[i] = x->next[i];
+        delete x;
+        while (level > 1 && !head.next[level - 1]) --level;
+        --size;
+        return true;
+    }
+
+    const Course* Find(const string& courseNumber) const {
+        const Node* x = &head;
+        for (int i = level - 1; i >= 0; --i) {
+            while (x->next[i] && x->next[i]->course.courseNumber < courseNumber) x = x->next[i];
+        }
+        x = x->next[0];
+        return x && x->course.courseNumber == courseNumber ? &x->course : nullptr;
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        for (const Node* x = head.next[0]; x; x = x->next[0]) visit(x->course);
+    }
+
+    int Size() const { return size; }
+};
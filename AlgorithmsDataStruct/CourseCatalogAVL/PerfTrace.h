@@ -0,0 +1,190 @@
+//============================================================================
+// Name        : PerfTrace.h
+// Author      : Sonny Coutu
+// Description : Timing spans for loads and tree operations, written as Chrome
+//               trace-event JSON (open in Perfetto or chrome://tracing).
+//               Phases and bulk operations get a span every time; per-course
+//               operations (insert, delete, row reads) only every Nth call,
+//               with descent depth and rotation counts as arguments.
+//               The TRACE_ macros compile to nothing unless CATALOG_TRACING
+//               is defined before this header is included; when compiled in,
+//               a span costs one relaxed load until capture is started.
+//============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class PerfTracer {
+public:
+    // Running totals read at the start and end of a span
+    enum Counter { ROTATIONS, DESCENTS, COUNTER_KINDS };
+
+private:
+    struct Event {
+        const char* name;
+        const char* category;
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint32_t thread;
+        std::string args;   // Preformatted JSON members, without braces
+    };
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<uint32_t> sampleEvery{ 64 };
+    std::atomic<uint64_t> counters[COUNTER_KINDS] = {};
+    std::atomic<uint32_t> nextThread{ 1 };
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::mutex lock;
+    std::vector<Event> events;
+
+public:
+    static PerfTracer& Global() {
+        static PerfTracer tracer;
+        return tracer;
+    }
+
+    bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Discards earlier events and starts recording; per-course spans are kept
+    // for one call in every sampleRate on each thread
+    void Start(uint32_t sampleRate = 64) {
+        std::lock_guard<std::mutex> guard(lock);
+        events.clear();
+        origin = std::chrono::steady_clock::now();
+        sampleEvery.store(sampleRate ? sampleRate : 1, std::memory_order_relaxed);
+        enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void Stop() { enabled.store(false, std::memory_order_relaxed); }
+
+    // True for one call in every sampleEvery on the calling thread
+    bool TakeSample() {
+        thread_local uint32_t countdown = 1;
+        if (--countdown > 0) return false;
+        countdown = sampleEvery.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    void Count(Counter counter) {
+        if (Enabled()) counters[counter].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t Total(Counter counter) const { return counters[counter].load(std::memory_order_relaxed); }
+
+    uint64_t NowNs() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count());
+    }
+
+    // Small stable number for the calling thread, used as the trace's tid
+    uint32_t ThreadId() {
+        thread_local uint32_t id = nextThread.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    void Complete(const char* name, const char* category, uint64_t startNs, uint64_t endNs, std::string args) {
+        Event e{ name, category, startNs, endNs - startNs, ThreadId(), std::move(args) };
+        std::lock_guard<std::mutex> guard(lock);
+        events.push_back(std::move(e));
+    }
+
+    size_t EventCount() {
+        std::lock_guard<std::mutex> guard(lock);
+        return events.size();
+    }
+
+    // Writes every recorded span as a Chrome trace-event "X" (complete) event
+    bool WriteJson(const std::string& path) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        char buffer[128];
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Event& e = events[i];
+            out += "{\"name\":\"";
+            out += e.name;
+            out += "\",\"cat\":\"";
+            out += e.category;
+            snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                     e.startNs / 1000.0, e.durationNs / 1000.0, e.thread);
+            out += buffer;
+            if (!e.args.empty()) out += ",\"args\":{" + e.args + "}";
+            out += i + 1 < events.size() ? "},\n" : "}\n";
+        }
+        out += "]}\n";
+
+        FILE* file = nullptr;
+#ifdef _MSC_VER
+        if (fopen_s(&file, path.c_str(), "wb") != 0) file = nullptr;
+#else
+        file = fopen(path.c_str(), "wb");
+#endif
+        if (!file) return false;
+        bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+        return fclose(file) == 0 && ok;
+    }
+};
+
+// One span from construction to destruction; inactive (and free apart from
+// the enabled check) while capture is off or the call was not sampled
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    uint64_t startNs = 0;
+    uint64_t startCounts[PerfTracer::COUNTER_KINDS] = {};
+    std::string args;
+
+public:
+    TraceSpan(const char* aName, const char* aCategory, bool sampled)
+        : name(aName), category(aCategory),
+          active(PerfTracer::Global().Enabled() && (!sampled || PerfTracer::Global().TakeSample())) {
+        if (!active) return;
+        PerfTracer& tracer = PerfTracer::Global();
+        for (int c = 0; c < PerfTracer::COUNTER_KINDS; ++c) startCounts[c] = tracer.Total(static_cast<PerfTracer::Counter>(c));
+        startNs = tracer.NowNs();
+    }
+
+    ~TraceSpan() {
+        if (!active) return;
+        PerfTracer& tracer = PerfTracer::Global();
+        uint64_t endNs = tracer.NowNs();
+        // Counters are process-wide, so a span overlapping other threads' work includes theirs
+        uint64_t rotations = tracer.Total(PerfTracer::ROTATIONS) - startCounts[PerfTracer::ROTATIONS];
+        uint64_t descents = tracer.Total(PerfTracer::DESCENTS) - startCounts[PerfTracer::DESCENTS];
+        if (rotations) Arg("rotations", static_cast<long long>(rotations));
+        if (descents) Arg("descents", static_cast<long long>(descents));
+        tracer.Complete(name, category, startNs, endNs, std::move(args));
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void Arg(const char* key, long long value) {
+        if (!active) return;
+        if (!args.empty()) args += ',';
+        args += '"';
+        args += key;
+        args += "\":";
+        args += std::to_string(value);
+    }
+};
+
+#ifdef CATALOG_TRACING
+#define TRACE_SCOPE(span, name, category) TraceSpan span(name, category, false)
+#define TRACE_SAMPLED_SCOPE(span, name, category) TraceSpan span(name, category, true)
+#define TRACE_ARG(span, key, value) span.Arg(key, static_cast<long long>(value))
+#define TRACE_COUNT(counter) PerfTracer::Global().Count(PerfTracer::counter)
+#else
+#define TRACE_SCOPE(span, name, category) ((void)0)
+#define TRACE_SAMPLED_SCOPE(span, name, category) ((void)0)
+#define TRACE_ARG(span, key, value) ((void)0)
+#define TRACE_COUNT(counter) ((void)0)
+#endif
@@ -0,0 +1,241 @@
+//============================================================================
+// Name        : ShardedCatalog.h
+// Author      : Sonny Coutu
+// Description : Catalog split into one AVL tree per department prefix
+//               ("CSCI", "MATH"). Lookups route by prefix, so each descent
+//               covers one department's tree instead of the whole catalog,
+//               and departments load and rebuild independently (in parallel
+//               on the work-stealing pool). Load also parses the CSV in
+//               parallel, one line-aligned byte range per task. Ordered
+//               traversal k-way merges
+//               the shards, so it is in global key order like a single tree.
+//               Satisfies the ordered-index operations in OrderedIndex.h.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <filesystem>
+
+class ShardedCatalog {
+private:
+    static const uint64_t MIN_RANGE_BYTES = 1 << 20; // Smaller files are not worth splitting
+
+    // Parses the rows that start in [begin, end) of the file. A range that
+    // does not start the file begins after the first line break at or after
+    // begin - 1, so every row is parsed by exactly one range.
+    static bool parseRange(const string& filePath, uint64_t begin, uint64_t end, vector<Course>& courses) {
+        ifstream inFS(filePath, ios::binary);
+        if (!inFS.is_open()) return false;
+        uint64_t start = begin;
+        if (begin > 0) {
+            inFS.seekg(static_cast<streamoff>(begin - 1));
+            for (char c; inFS.get(c) && c != '\n' && c != '\r';) ++start;
+            if (!inFS) return true; // no row starts in this range
+        }
+        inFS.seekg(static_cast<streamoff>(start));
+        CsvReader reader(inFS);
+        vector<string_view> fields;
+        while (reader.NextRow(fields) && start + reader.RowOffset() < end) {
+            if (fields.size() < 2) continue;
+            Course aCourse{ string(fields[0]), string(fields[1]), {} };
+            for (size_t i = 2; i < fields.size(); ++i) {
+                if (!fields[i].empty()) aCourse.preReqs.emplace_back(fields[i]);
+            }
+            courses.push_back(move(aCourse));
+        }
+        return true;
+    }
+
+    map<string, unique_ptr<BinarySearchTree>, less<>> shards; // Department -> its courses
+    int size = 0;
+
+    BinarySearchTree* shardFor(string_view courseNumber) const {
+        auto it = shards.find(departmentOf(courseNumber));
+        return it == shards.end() ? nullptr : it->second.get();
+    }
+
+    BinarySearchTree& shardOrCreate(string_view courseNumber) {
+        string_view department = departmentOf(courseNumber);
+        auto it = shards.find(department);
+        if (it == shards.end()) it = shards.emplace(string(department), make_unique<BinarySearchTree>()).first;
+        return *it->second;
+    }
+
+    void recount() {
+        size = 0;
+        for (auto& entry : shards) size += entry.second->Size();
+    }
+
+public:
+    // Merges one cursor per shard: always returns the smallest current
+    // course, so courses come out in global key order even where two
+    // departments' ID ranges interleave. Invalidated by any modification.
+    class Cursor {
+    private:
+        struct Head {
+            const Course* course;
+            BinarySearchTree::Cursor rest;
+        };
+        vector<Head> heap; // Min-heap on the head course's ID
+
+        static bool later(const Head& a, const Head& b) { return a.course->courseNumber > b.course->courseNumber; }
+
+    public:
+        Cursor(const ShardedCatalog& catalog, const string& from) {
+            for (const auto& entry : catalog.shards) {
+                BinarySearchTree::Cursor rest = entry.second->Begin(from);
+                if (const Course* first = rest.Next()) heap.push_back(Head{ first, move(rest) });
+            }
+            make_heap(heap.begin(), heap.end(), later);
+        }
+
+        // Next course in key order, or nullptr once every shard is exhausted
+        const Course* Next() {
+            if (heap.empty()) return nullptr;
+            pop_heap(heap.begin(), heap.end(), later);
+            Head& top = heap.back();
+            const Course* result = top.course;
+            top.course = top.rest.Next();
+            if (top.course) push_heap(heap.begin(), heap.end(), later);
+            else heap.pop_back();
+            return result;
+        }
+    };
+
+    Cursor Begin(const string& from = "") const { return Cursor(*this, from); }
+
+    void Insert(const Course& aCourse) {
+        BinarySearchTree& shard = shardOrCreate(aCourse.courseNumber);
+        size -= shard.Size();
+        shard.Insert(aCourse);
+        size += shard.Size();
+    }
+
+    bool Delete(const string& courseNumber) {
+        auto it = shards.find(departmentOf(courseNumber));
+        if (it == shards.end() || !it->second->Delete(courseNumber)) return false;
+        --size;
+        if (it->second->Size() == 0) shards.erase(it);
+        return true;
+    }
+
+    const Course* Find(const string& courseNumber) const {
+        BinarySearchTree* shard = shardFor(courseNumber);
+        return shard ? shard->Find(courseNumber) : nullptr;
+    }
+
+    // Case-insensitive lookup by ID, like BinarySearchTree::Search
+    Course Search(string courseId) {
+        convertCase(courseId);
+        BinarySearchTree* shard = shardFor(courseId);
+        return shard ? shard->Search(courseId) : Course();
+    }
+
+    // Visit every course in global key order
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        Cursor cursor(*this, "");
+        while (const Course* c = cursor.Next()) visit(*c);
+    }
+
+    // Visit, in key order, every course whose ID starts with prefix; a prefix
+    // of letters only ("CS") can span several departments ("CS", "CSCI")
+    template <typename Visitor>
+    void ForEachPrefix(const string& prefix, Visitor visit) const {
+        if (departmentOf(prefix).size() < prefix.size()) {
+            if (BinarySearchTree* shard = shardFor(prefix)) shard->ForEachPrefix(prefix, visit);
+            return;
+        }
+        Cursor cursor(*this, prefix);
+        while (const Course* c = cursor.Next()) {
+            if (c->courseNumber.compare(0, prefix.size(), prefix) != 0) break;
+            visit(*c);
+        }
+    }
+
+    // Routes a batch to its departments and bulk-inserts each one in parallel.
+    // Existing courses win over batch entries with the same ID, as with Insert.
+    void InsertBatch(vector<Course> courses) {
+        map<string, vector<Course>, less<>> byDepartment;
+        for (Course& c : courses) {
+            string_view department = departmentOf(c.courseNumber);
+            auto it = byDepartment.find(department);
+            if (it == byDepartment.end()) it = byDepartment.emplace(string(department), vector<Course>()).first;
+            it->second.push_back(move(c));
+        }
+        for (auto& entry : byDepartment) shardOrCreate(entry.first);
+
+        TaskGroup group;
+        for (auto& entry : byDepartment) {
+            BinarySearchTree* shard = shards.find(entry.first)->second.get();
+            vector<Course>* batch = &entry.second;
+            group.Spawn([shard, batch] { shard->InsertBatch(move(*batch)); });
+        }
+        group.Wait();
+        recount();
+    }
+
+    // Loads a catalog CSV. The file is cut into byte ranges that are parsed on
+    // the pool at once; the rows are then split by department and every
+    // department's tree is sorted and built on its own worker. The first row
+    // for an ID wins, as with a sequential load.
+    bool Load(const string& filePath) {
+        error_code ec;
+        uint64_t fileBytes = filesystem::file_size(filePath, ec);
+        if (ec) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return false;
+        }
+        size_t maxRanges = (WorkStealingPool::Shared().Workers() + 1) * 4; // a few per thread evens out the load
+        size_t rangeCount = static_cast<size_t>(max<uint64_t>(1, min<uint64_t>(maxRanges, fileBytes / MIN_RANGE_BYTES)));
+        vector<vector<Course>> parsed(rangeCount);
+        vector<char> ok(rangeCount, 0);
+        {
+            TaskGroup group;
+            for (size_t i = 0; i < rangeCount; ++i) {
+                group.Spawn([&, i] {
+                    ok[i] = parseRange(filePath, fileBytes * i / rangeCount, fileBytes * (i + 1) / rangeCount, parsed[i]);
+                });
+            }
+            group.Wait();
+        }
+        if (find(ok.begin(), ok.end(), 0) != ok.end()) {
+            cout << "Could not open file (" << filePath << ")." << endl;
+            return false;
+        }
+        vector<Course> courses; // File order, so sortUnique keeps each ID's first row
+        size_t total = 0;
+        for (const vector<Course>& range : parsed) total += range.size();
+        courses.reserve(total);
+        for (vector<Course>& range : parsed) move(range.begin(), range.end(), back_inserter(courses));
+        InsertBatch(move(courses));
+        return true;
+    }
+
+    // Replaces one department's courses without touching any other shard;
+    // courses outside the department are ignored
+    void RebuildDepartment(const string& department, vector<Course> courses) {
+        courses.erase(remove_if(courses.begin(), courses.end(),
+            [&department](const Course& c) { return departmentOf(c.courseNumber) != department; }), courses.end());
+        shards.erase(department);
+        if (!courses.empty()) shardOrCreate(department).InsertBatch(move(courses));
+        recount();
+    }
+
+    // One department's tree, or nullptr if it has no courses
+    const BinarySearchTree* Shard(const string& department) const {
+        auto it = shards.find(department);
+        return it == shards.end() ? nullptr : it->second.get();
+    }
+
+    // Department prefixes in key order
+    vector<string> Departments() const {
+        vector<string> names;
+        for (const auto& entry : shards) names.push_back(entry.first);
+        return names;
+    }
+
+    int Size() const { return size; }
+};
@@ -0,0 +1,171 @@
+//============================================================================
+// Name        : WorkStealingPool.h
+// Author      : Sonny Coutu
+// Description : Small work-stealing thread pool for fork-join tree work.
+//               Every worker owns a deque: it pushes and pops its own tasks at
+//               the back (newest, still warm in cache) and steals from the
+//               front of other deques (oldest, usually the biggest subtrees).
+//               A thread waiting on a TaskGroup runs queued tasks meanwhile,
+//               so nested fork-join never blocks a worker, and sleeps only
+//               when there is nothing left to run.
+//============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+private:
+    struct TaskQueue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues; // One per worker, plus a last one shared by outside threads
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepLock;
+    std::condition_variable wake;
+
+    // Index of the calling thread's own queue, or the shared queue for outsiders
+    size_t ownQueue() const {
+        return currentPool() == this ? currentIndex() : queues.size() - 1;
+    }
+
+    static const WorkStealingPool*& currentPool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static size_t& currentIndex() {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    bool popBack(size_t q, std::function<void()>& task) {
+        std::lock_guard<std::mutex> guard(queues[q]->lock);
+        if (queues[q]->tasks.empty()) return false;
+        task = std::move(queues[q]->tasks.back());
+        queues[q]->tasks.pop_back();
+        return true;
+    }
+
+    bool stealFront(size_t q, std::function<void()>& task) {
+        std::lock_guard<std::mutex> guard(queues[q]->lock);
+        if (queues[q]->tasks.empty()) return false;
+        task = std::move(queues[q]->tasks.front());
+        queues[q]->tasks.pop_front();
+        return true;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool() = this;
+        currentIndex() = index;
+        while (!stopping) {
+            if (RunOne()) continue;
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || queued > 0; });
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t workers = std::max(1u, std::thread::hardware_concurrency()) - 1) {
+        if (workers == 0) workers = 1;
+        for (size_t i = 0; i <= workers; ++i) queues.push_back(std::make_unique<TaskQueue>());
+        for (size_t i = 0; i < workers; ++i) threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void Submit(std::function<void()> task) {
+        size_t q = ownQueue();
+        {
+            std::lock_guard<std::mutex> guard(queues[q]->lock);
+            queues[q]->tasks.push_back(std::move(task));
+        }
+        ++queued;
+        { std::lock_guard<std::mutex> guard(sleepLock); } // a worker about to sleep sees queued first
+        wake.notify_one();
+    }
+
+    // Runs one queued task, own queue first, then stealing; false if none was found
+    bool RunOne() {
+        std::function<void()> task;
+        size_t own = ownQueue();
+        bool found = popBack(own, task);
+        for (size_t i = 1; !found && i < queues.size(); ++i) found = stealFront((own + i) % queues.size(), task);
+        if (!found) return false;
+        --queued;
+        task();
+        return true;
+    }
+
+    // Runs queued tasks until done() holds, sleeping while none are queued.
+    // Whatever makes done() true must call NotifyWaiters afterwards.
+    template <typename Done>
+    void RunUntil(Done done) {
+        while (!done()) {
+            if (RunOne()) continue;
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this, &done] { return done() || queued > 0; });
+        }
+    }
+
+    void NotifyWaiters() {
+        { std::lock_guard<std::mutex> guard(sleepLock); } // a waiter about to sleep sees done() first
+        wake.notify_all();
+    }
+
+    size_t Workers() const { return threads.size(); }
+
+    // Pool shared by the catalog's parallel operations
+    static WorkStealingPool& Shared() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+};
+
+// Tasks forked together and joined with Wait
+class TaskGroup {
+private:
+    WorkStealingPool& pool;
+    std::atomic<size_t> pending{ 0 };
+
+public:
+    explicit TaskGroup(WorkStealingPool& aPool = WorkStealingPool::Shared()) : pool(aPool) {}
+    ~TaskGroup() { Wait(); }
+
+    template <typename Fn>
+    void Spawn(Fn fn) {
+        ++pending;
+        pool.Submit([this, target = &pool, fn]() mutable {
+            fn();
+            if (--pending == 0) target->NotifyWaiters(); // the group may be gone once pending is 0
+        });
+    }
+
+    // Helps run queued tasks until every spawned task has finished, blocking
+    // while the last ones run on other threads
+    void Wait() {
+        pool.RunUntil([this] { return pending == 0; });
+    }
+};
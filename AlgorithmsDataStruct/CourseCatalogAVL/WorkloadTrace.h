@@ -0,0 +1,261 @@
+//============================================================================
+// Name        : WorkloadTrace.h
+// Author      : Sonny Coutu
+// Description : Reproducible catalog workloads. A trace is a text file with
+//               one operation per line, "<op> <argument>":
+//                 L courses.csv     load (or reload) the catalog
+//                 F CSCI101         find by ID
+//                 I CSCI999,Name,.. insert a course (a CSV row)
+//                 D CSCI101         delete by ID
+//                 M extra.csv       merge courses from another file
+//                 T                 full in-order traversal
+//               Traces are recorded from the menu (--record) or generated
+//               with a read/write mix and uniform, Zipfian or hot-spot keys,
+//               then replayed at full speed with per-operation latencies.
+//============================================================================
+
+#pragma once
+
+#include "CourseCatalog.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+struct TraceEntry {
+    char op;
+    string arg;
+};
+
+// Appends menu operations to a trace file as they happen; a no-op until opened
+class WorkloadRecorder {
+private:
+    ofstream out;
+
+public:
+    bool Open(const string& tracePath) {
+        out.open(tracePath, ios::binary | ios::trunc);
+        if (!out.is_open()) cout << "Could not open trace file (" << tracePath << ")." << endl;
+        return out.is_open();
+    }
+
+    void Record(char op, const string& arg = "") {
+        if (!out.is_open()) return;
+        out << op;
+        if (!arg.empty()) out << ' ' << arg;
+        out << '\n';
+        out.flush(); // the menu can be left with Ctrl+C
+    }
+
+    bool Recording() const { return out.is_open(); }
+};
+
+inline bool readTrace(const string& tracePath, vector<TraceEntry>& trace) {
+    ifstream in(tracePath, ios::binary);
+    if (!in.is_open()) {
+        cout << "Could not open trace file (" << tracePath << ")." << endl;
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        trace.push_back(TraceEntry{ line[0], line.size() > 2 ? line.substr(2) : "" });
+    }
+    return true;
+}
+
+inline bool writeTrace(const string& tracePath, const vector<TraceEntry>& trace) {
+    ofstream out(tracePath, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Could not open trace file (" << tracePath << ")." << endl;
+        return false;
+    }
+    string text;
+    for (const TraceEntry& e : trace) {
+        text += e.op;
+        if (!e.arg.empty()) text += ' ' + e.arg;
+        text += '\n';
+    }
+    out << text;
+    return true;
+}
+
+// ---------------- Key distributions ----------------
+
+// How a synthetic workload picks which of n keys an operation touches
+struct KeyDistribution {
+    enum Kind { UNIFORM, ZIPF, HOTSPOT } kind = UNIFORM;
+    double zipfExponent = 0.99;     // ZIPF: weight of rank r is 1 / r^s
+    double hotKeys = 0.1;           // HOTSPOT: fraction of keys that are hot
+    double hotShare = 0.9;          //   and the fraction of operations they get
+
+    // Parses "uniform", "zipf[:s]" or "hotspot[:hotKeys:hotShare]"
+    static bool Parse(const string& text, KeyDistribution& dist) {
+        vector<string> parts;
+        stringstream ss(text);
+        for (string part; getline(ss, part, ':');) parts.push_back(part);
+        if (parts.empty()) return false;
+        if (parts[0] == "uniform" && parts.size() == 1) dist.kind = UNIFORM;
+        else if (parts[0] == "zipf" && parts.size() <= 2) {
+            dist.kind = ZIPF;
+            if (parts.size() == 2) dist.zipfExponent = atof(parts[1].c_str());
+        }
+        else if (parts[0] == "hotspot" && parts.size() != 2 && parts.size() <= 3) {
+            dist.kind = HOTSPOT;
+            if (parts.size() == 3) {
+                dist.hotKeys = atof(parts[1].c_str());
+                dist.hotShare = atof(parts[2].c_str());
+            }
+        }
+        else return false;
+        return dist.zipfExponent > 0 && dist.hotKeys > 0 && dist.hotKeys <= 1 && dist.hotShare >= 0 && dist.hotShare <= 1;
+    }
+};
+
+// Draws key ranks in [0, n); rank 0 is the most popular under ZIPF and the
+// first hotKeys * n ranks are hot under HOTSPOT
+class KeySampler {
+private:
+    KeyDistribution dist;
+    size_t n;
+    vector<double> zipfCdf; // Cumulative rank weights, normalized to end at 1
+    size_t hotCount = 0;
+
+public:
+    KeySampler(const KeyDistribution& aDist, size_t keyCount) : dist(aDist), n(keyCount) {
+        if (dist.kind == KeyDistribution::ZIPF) {
+            zipfCdf.resize(n);
+            double sum = 0;
+            for (size_t r = 0; r < n; ++r) zipfCdf[r] = sum += 1.0 / pow(static_cast<double>(r + 1), dist.zipfExponent);
+            for (double& c : zipfCdf) c /= sum;
+        }
+        hotCount = max<size_t>(1, static_cast<size_t>(dist.hotKeys * static_cast<double>(n)));
+    }
+
+    size_t operator()(mt19937_64& rng) const {
+        uniform_real_distribution<double> unit(0.0, 1.0);
+        switch (dist.kind) {
+        case KeyDistribution::ZIPF:
+            return min(n - 1, static_cast<size_t>(lower_bound(zipfCdf.begin(), zipfCdf.end(), unit(rng)) - zipfCdf.begin()));
+        case KeyDistribution::HOTSPOT:
+            if (hotCount >= n || unit(rng) < dist.hotShare) return rng() % hotCount;
+            return hotCount + rng() % (n - hotCount);
+        default:
+            return rng() % n;
+        }
+    }
+};
+
+// A load of csvPath followed by opCount finds, inserts and deletes over the
+// catalog's own courses. Writes toggle a course: delete it if present,
+// insert it back if not, so the catalog size stays near its loaded size.
+// Key ranks are shuffled onto IDs so popular keys are spread over the tree.
+inline vector<TraceEntry> generateWorkload(const string& csvPath, const vector<Course>& courses, size_t opCount,
+                                           double readRatio, const KeyDistribution& dist, uint64_t seed) {
+    vector<TraceEntry> trace;
+    trace.push_back(TraceEntry{ 'L', csvPath });
+    if (courses.empty()) return trace;
+
+    mt19937_64 rng(seed);
+    vector<size_t> byRank(courses.size());
+    for (size_t i = 0; i < byRank.size(); ++i) byRank[i] = i;
+    shuffle(byRank.begin(), byRank.end(), rng);
+    vector<bool> present(courses.size(), true);
+    KeySampler sampler(dist, courses.size());
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (size_t i = 0; i < opCount; ++i) {
+        size_t c = byRank[sampler(rng)];
+        if (unit(rng) < readRatio) trace.push_back(TraceEntry{ 'F', courses[c].courseNumber });
+        else if (present[c]) {
+            trace.push_back(TraceEntry{ 'D', courses[c].courseNumber });
+            present[c] = false;
+        }
+        else {
+            string row;
+            appendCsvRow(row, courses[c]);
+            trace.push_back(TraceEntry{ 'I', row });
+            present[c] = true;
+        }
+    }
+    return trace;
+}
+
+// ---------------- Replay ----------------
+
+// Latencies of one operation kind, in nanoseconds
+struct OpLatencies {
+    vector<double> nanos;
+    size_t misses = 0; // Finds and deletes of IDs not in the catalog
+
+    // p in [0, 1]; sorts on first use
+    double Percentile(double p) {
+        if (nanos.empty()) return 0;
+        if (!is_sorted(nanos.begin(), nanos.end())) sort(nanos.begin(), nanos.end());
+        return nanos[static_cast<size_t>(p * static_cast<double>(nanos.size() - 1))];
+    }
+};
+
+struct ReplayResult {
+    map<char, OpLatencies> byOp;
+    size_t operations = 0;
+    double seconds = 0;     // Wall time of the whole replay
+    size_t skipped = 0;     // Lines with an unknown op
+    size_t checksum = 0;    // Folded from every result so no operation is optimized away
+};
+
+// Runs the trace against catalog as fast as it will go, timing every operation
+inline ReplayResult replayTrace(const vector<TraceEntry>& trace, BinarySearchTree& catalog) {
+    ReplayResult result;
+    size_t sink = 0;
+    auto replayStart = chrono::steady_clock::now();
+    for (const TraceEntry& e : trace) {
+        auto start = chrono::steady_clock::now();
+        bool hit = true;
+        switch (e.op) {
+        case 'L':
+            if (catalog.Size() == 0) loadCourses(e.arg, &catalog);
+            else catalog.Reload(e.arg);
+            break;
+        case 'F':
+            hit = catalog.Find(e.arg) != nullptr;
+            break;
+        case 'I': {
+            vector<string_view> fields;
+            splitRow(e.arg, fields);
+            if (fields.size() < 2) break;
+            Course c{ string(fields[0]), string(fields[1]), {} };
+            for (size_t i = 2; i < fields.size(); ++i) {
+                if (!fields[i].empty()) c.preReqs.emplace_back(fields[i]);
+            }
+            catalog.Insert(c);
+            break;
+        }
+        case 'D':
+            hit = catalog.Delete(e.arg);
+            break;
+        case 'M': {
+            BinarySearchTree incoming;
+            loadCourses(e.arg, &incoming);
+            catalog.Union(incoming);
+            break;
+        }
+        case 'T':
+            catalog.ForEach([&sink](const Course& c) { sink += c.courseName.size(); });
+            break;
+        default:
+            ++result.skipped;
+            continue;
+        }
+        double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        OpLatencies& op = result.byOp[e.op];
+        op.nanos.push_back(nanos);
+        op.misses += !hit;
+        sink += hit;
+        ++result.operations;
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+    result.checksum = sink;
+    return result;
+}